@@ -32,11 +32,33 @@ class Generator
         BODY
     };
 
+    //opis jednog automata za table.hpp, popunjava se dok se čita pravilo
+    struct CppAutomaton {
+        State state;
+        std::string name;
+        ID start, end;
+        ID cmd_begin, cmd_end;
+        int dfa;
+    };
+
     std::ifstream in;
     std::ofstream out;
     bool read_stdin = false;
     bool write_stdout = false;
 
+    State cpp_start;
+    Container<std::string> cpp_links;
+    Container<std::string> cpp_commands;
+    Container<CppAutomaton> cpp_automata;
+    Container<std::string> cpp_dfas;
+    Container<int32_t> cpp_dfa_next;
+    Container<uint16_t> cpp_dfa_class;
+    Container<uint8_t> cpp_dfa_accept;
+
+public:
+    //pravila čiji DKA ima najviše ovoliko stanja se determiniziraju, ostala ostaju NKA (0 isključuje DKA)
+    size_t dfa_budget = 1000;
+
 public:
 
     Generator(const std::string& inputStream = "cin", const std::string& outStream = "") 
@@ -81,6 +103,7 @@ public:
                     consumeEachWord(line, [this, fst, &first](std::string&& word) mutable {
                         if (first) {
                             GEN_OUT <<word <<std::endl;
+                            cpp_start = word;
                             first = false;
                         }
                     });
@@ -95,19 +118,37 @@ public:
                 if (phase == BODY) {
                     fst = readNextWord(line);
                     if (fst[0] == '}') phase = HEADER;
-                    else out <<"cmd:" <<line <<std::endl;
+                    else {
+                        out <<"cmd:" <<line <<std::endl;
+                        cpp_commands.push_back(add_command(convert_to_raw(line).c_str()));
+                        cpp_automata.back().cmd_end++;
+                    }
                 } else {
                     fst = consumeNextWord(line, '>');
                     state = fst.substr(1, fst.size()-1);
                     GEN_OUT <<"atm:" <<state <<std::endl;
-                    NKA nka = consumeNextWord(line);
-                    for (ID id1 = 0; id1 < nka.size(); id1++) 
-                        for (char s : nka.get_transition_symbols(id1))
-                            for (ID id2 : nka.get_transitions(id1, s))
-                                if (id1 != id2) GEN_OUT <<"lnk:" <<id1 <<" " <<id2 <<" " <<(int)s <<std::endl;
-                    GEN_OUT <<"end:" <<nka.start <<" " <<nka.end <<std::endl;
+                    id++;
+                    NKA nka = Regex(consumeNextWord(line)).factor();
+                    DKA dka;
+                    int dfa = -1;
+                    if (dfa_budget && dka.build(nka, dfa_budget)) {
+                        dfa = cpp_dfas.size();
+                        write_dfa(dka);
+                    }
+                    else {
+                        for (ID id1 = 0; id1 < nka.size(); id1++) 
+                            for (char s : nka.get_transition_symbols(id1))
+                                for (ID id2 : nka.get_transitions(id1, s))
+                                    if (id1 != id2) {
+                                        GEN_OUT <<"lnk:" <<id1 <<" " <<id2 <<" " <<(int)s <<std::endl;
+                                        cpp_links.push_back(add_link(id, id1, id2, (int)s));
+                                    }
+                        GEN_OUT <<"end:" <<nka.start <<" " <<nka.end <<std::endl;
+                    }
                     getline(GEN_IN); getline(GEN_IN);
                     GEN_OUT <<"name:" <<line <<std::endl;
+                    ID cmd = cpp_commands.size();
+                    cpp_automata.push_back({state, line, nka.start, nka.end, cmd, cmd, dfa});
                     phase = BODY;
                 }
             }
@@ -118,12 +159,109 @@ public:
         else 
             std::cerr << "Unable to open file or stream!" << "\n";
     }
+
+private:
+
+    /* zapis DKA u table.txt:
+        dfa:<broj stanja> <broj razreda>
+        cls:<znak> <razred>         za svaki znak koji ima prijelaz
+        trn:<stanje> <razred> <stanje>
+        acc:<stanje>
+    */
+    void write_dfa(const DKA& dka) 
+    {
+        std::ostream& gen_out = write_stdout ? std::cout : this->out;
+
+        cpp_dfas.push_back(add_dfa(dka.states, dka.class_count, (int) cpp_dfa_next.size(), (int) cpp_dfa_accept.size()));
+        cpp_dfa_next.insert(cpp_dfa_next.end(), dka.next.begin(), dka.next.end());
+        cpp_dfa_class.insert(cpp_dfa_class.end(), dka.classes.begin(), dka.classes.end());
+        cpp_dfa_accept.insert(cpp_dfa_accept.end(), dka.accept.begin(), dka.accept.end());
+
+        gen_out <<"dfa:" <<dka.states <<" " <<dka.class_count <<"\n";
+        for (int c = 0; c < 256; c++)
+            if (dka.classes[c]) gen_out <<"cls:" <<c <<" " <<dka.classes[c] <<"\n";
+        for (ID s = 0; s < dka.states; s++)
+            for (ID c = 1; c < dka.class_count; c++)
+                if (dka.next[s * dka.class_count + c] != -1)
+                    gen_out <<"trn:" <<s <<" " <<c <<" " <<dka.next[s * dka.class_count + c] <<"\n";
+        for (ID s = 0; s < dka.states; s++)
+            if (dka.accept[s]) gen_out <<"acc:" <<s <<"\n";
+    }
+
+    template<typename T>
+    static void write_cpp_array(std::ostream& cpp, const char* type, const char* name, const Container<T>& values) 
+    {
+        cpp <<indent <<begin_array(type, name);
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i % 16 == 0) cpp <<"\n" <<indent2;
+            cpp <<(int) values[i] <<", ";
+        }
+        cpp <<"\n" <<indent2 <<"0" <<std::endl;
+        cpp <<indent <<"};" <<std::endl <<std::endl;
+    }
+
+public:
+
+    //zapisuje tablicu pročitanu u generate() kao constexpr nizove (predložak je u filegen_defs.hpp)
+    void generate_cpp(const std::string& file) 
+    {
+        std::ofstream cpp(file);
+
+        cpp <<CPP_BEGIN <<std::endl;
+        cpp <<indent <<set_start(convert_to_raw(cpp_start).c_str()) <<std::endl <<std::endl;
+
+        cpp <<indent <<begin_array("Link", "LINKS") <<std::endl;
+        for (const std::string& link : cpp_links) 
+            cpp <<indent2 <<link <<std::endl;
+        cpp <<indent2 <<"{}" <<std::endl;
+        cpp <<indent <<end_array("LINK", (int) cpp_links.size()) <<std::endl <<std::endl;
+
+        cpp <<indent <<begin_array("Automaton", "AUTOMATA") <<std::endl;
+        for (const CppAutomaton& atm : cpp_automata) 
+            cpp <<indent2 <<add_automata(
+                convert_to_raw(atm.state).c_str(), convert_to_raw(atm.name).c_str(), 
+                atm.start, atm.end, atm.cmd_begin, atm.cmd_end, atm.dfa
+            ) <<std::endl;
+        cpp <<indent2 <<"{}" <<std::endl;
+        cpp <<indent <<end_array("AUTOMATA", (int) cpp_automata.size()) <<std::endl <<std::endl;
+
+        cpp <<indent <<begin_array("Dfa", "DFAS") <<std::endl;
+        for (const std::string& dfa : cpp_dfas) 
+            cpp <<indent2 <<dfa <<std::endl;
+        cpp <<indent2 <<"{}" <<std::endl;
+        cpp <<indent <<end_array("DFA", (int) cpp_dfas.size()) <<std::endl <<std::endl;
+
+        write_cpp_array(cpp, "int32_t", "DFA_NEXT", cpp_dfa_next);
+        write_cpp_array(cpp, "uint16_t", "DFA_CLASS", cpp_dfa_class);
+        write_cpp_array(cpp, "uint8_t", "DFA_ACCEPT", cpp_dfa_accept);
+
+        cpp <<indent <<begin_array("const char*", "COMMANDS") <<std::endl;
+        for (const std::string& command : cpp_commands) 
+            cpp <<indent2 <<command <<std::endl;
+        cpp <<indent2 <<"nullptr" <<std::endl;
+        cpp <<indent <<end_array("COMMAND", (int) cpp_commands.size()) <<std::endl;
+
+        cpp <<CPP_END <<std::endl;
+    }
 };
 
-int main () 
+int main (int argc, char** argv) 
 {
     // std::string file;
     // std::cin >>file;
-    // Generator("input/state_hopper.lan", "analizator/table.hpp").generate();
-    Generator("cin", "analizator/table.txt").generate();
+    /* zastavice:
+        --cpp               dodatno zapisuje tablicu kao header za analizator preveden s -DEMBEDDED_TABLE
+        --dfa-budget N      najveći broj stanja DKA po pravilu, pravila koja ga premaše ostaju NKA
+    */
+    bool cpp = false;
+    Generator generator("cin", "analizator/table.txt");
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cpp") cpp = true;
+        else if (arg == "--dfa-budget" && i + 1 < argc) generator.dfa_budget = to_int(argv[++i]);
+    }
+
+    generator.generate();
+
+    if (cpp) generator.generate_cpp("analizator/table.hpp");
 }
\ No newline at end of file
@@ -286,6 +286,118 @@ std::string Regex::reduce() const {
     return a;
 }
 
+/* opis:
+    Ako je regex niz običnih znakova bez kleena (ili prazan), u atoms spremi zapis svakog znaka i vrati true.
+    Posebni znakovi (\n, \| ...) se spremaju zajedno s '\' kako bi se mogli ponovno parsirati.
+*/
+bool Regex::literal(std::deque<std::string>& atoms) const {
+    if (kleen) return false;
+    if (regex_type == ATOMIC) {
+        if (size) atoms.emplace_back(atom());
+        return true;
+    }
+    if (regex_type != HAS_JOIN) return false;
+    for (const Regex& r : subdivisions) {
+        if (r.regex_type != ATOMIC || r.kleen) return false;
+        if (r.size) atoms.emplace_back(r.atom());
+    }
+    return true;
+}
+
+//zapis znaka ATOMIC regexa, čita se isto kao u get() pa ne ovisi o tome koliko je znakova završilo u segmentu
+std::string Regex::atom() const {
+    if (!size) return "";
+    if (is_special) return std::string{'\\', exp[1]};
+    return std::string(1, exp[0]);
+}
+
+namespace {
+    //čvor prefiksnog stabla, djeca su u redoslijedu pojavljivanja da izlaz bude deterministički
+    struct Trie {
+        bool terminal = false;
+        std::deque<std::pair<std::string, Trie>> next;
+
+        void insert(const std::deque<std::string>& atoms, size_t at = 0) {
+            if (at == atoms.size()) {
+                terminal = true;
+                return;
+            }
+            for (auto& [atom, child] : next)
+                if (atom == atoms[at])
+                    return child.insert(atoms, at + 1);
+            next.emplace_back(atoms[at], Trie());
+            next.back().second.insert(atoms, at + 1);
+        }
+
+        //alternative ovog čvora, prazna alternativa se piše kao BLANK
+        std::deque<std::string> alternatives() const {
+            std::deque<std::string> rez;
+            for (const auto& [atom, child] : next)
+                rez.emplace_back(atom + child.str());
+            if (terminal && !next.empty())
+                rez.emplace_back(1, BLANK);
+            return rez;
+        }
+
+        std::string str() const {
+            std::deque<std::string> alt = alternatives();
+            if (alt.empty()) return "";
+            if (alt.size() == 1) return alt.front();
+            std::string a(1, BRA);
+            for (size_t i = 0; i < alt.size(); i++) {
+                if (i) a += SEPARATOR;
+                a += alt[i];
+            }
+            return a + KET;
+        }
+    };
+}
+
+/* opis:
+    Radi kao reduce(), ali alternative koje su čisti nizovi znakova slaže u prefiksno stablo.
+    Time svaki zajednički prefiks u NKA postaje samo jedan lanac stanja umjesto zasebne grane za svaku alternativu,
+    a alternative od po jednog znaka završe kao skup znakova (a|b|c) koji NKA::parseRegex povezuje izravno.
+*/
+std::string Regex::factor() const {
+    if (regex_type != HAS_SEPARATOR) {
+        if (regex_type == ATOMIC) return kleen ? atom() + KLEEN : atom();
+        std::string a;
+        if (kleen) a += BRA;
+        for (const Regex& r : subdivisions) a += r.factor();
+        if (kleen) a += KET;
+        if (kleen) a += KLEEN;
+        return a;
+    }
+
+    Trie trie;
+    std::deque<std::string> alt;
+    bool literals = false;
+    for (const Regex& r : subdivisions) {
+        std::deque<std::string> atoms;
+        if (r.literal(atoms)) {
+            trie.insert(atoms);
+            literals = true;
+        }
+        else alt.emplace_back(r.factor());
+    }
+    if (literals) {
+        std::deque<std::string> fst = trie.alternatives();
+        if (fst.empty()) fst.emplace_back(1, BLANK); //jedina literalna alternativa je prazna
+        alt.insert(alt.begin(), fst.begin(), fst.end());
+    }
+
+    std::string a;
+    bool bracket = !is_str_const || kleen;
+    if (bracket) a += BRA;
+    for (size_t i = 0; i < alt.size(); i++) {
+        if (i) a += SEPARATOR;
+        a += alt[i];
+    }
+    if (bracket) a += KET;
+    if (kleen) a += KLEEN;
+    return a;
+}
+
 //overload za ispis regexa
 std::ostream &operator<< (std::ostream& os, const Regex& r) {
     os <<(std::string) r;
@@ -100,6 +100,11 @@ public:
     //vraca pojednostavljeni regex
     std::string reduce() const;
 
+    /*vraca pojednostavljeni regex u kojem su alternative koje su čisti nizovi znakova složene u trie
+        zajednički prefiksi se izlučuju (int|if|inline -> i(n(t|line)|f)), a ostale alternative ostaju kao u reduce()
+    */
+    std::string factor() const;
+
     //radi samo za ATOMIC tip, vraća sadržani simbol
     char get() const;
     
@@ -120,6 +125,8 @@ public:
 
 private:
     void assertType(Type type = HAS_SEPARATOR);
+    bool literal(std::deque<std::string>& atoms) const;
+    std::string atom() const;
     void vectorize_string (char deliminator);
 };
 
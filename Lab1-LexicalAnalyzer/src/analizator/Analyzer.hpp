@@ -0,0 +1,280 @@
+#pragma once
+
+#include"automata.hpp"
+#include<iostream>
+#include<fstream>
+#include<stdexcept>
+#include<string_view>
+#ifdef EMBEDDED_TABLE
+#include"table.hpp" //generira ./generator --cpp
+#endif
+
+//sve je u namespaceu da se analizator može uključiti zajedno sa sintaksnim analizatorom (Lab2)
+namespace lex
+{
+
+using State = std::string;
+using ID = uint32_t;
+
+template<typename T>
+using Container = std::vector<T>;
+
+static Container<State> STATES;
+static Container<std::string> SYMBOLS;
+static std::map<ID, Automaton> AUTOMATA;
+static std::map<State, Container<ID>> TABLE;
+static State START;
+
+/*
+    Leksička jedinka koju vraća Analyzer::next_token()
+    rule je id pravila (indeks u AUTOMATA), ime jedinke je AUTOMATA[rule].name
+    lexeme pokazuje u ulazni buffer analizatora pa vrijedi dok god je živ ulazni string
+*/
+struct Token {
+    ID rule;
+    int line;
+    std::string_view lexeme;
+};
+
+/* kako koristiti:
+    Analyzer se stvara nad cijelim ulazom (string mora živjeti dok se koriste tokeni).
+    next_token() vraća sljedeću jedinku (pravila s imenom "-" se preskaču) i false kada dođe do kraja ulaza,
+    analyze() samo ispisuje sve jedinke na cout u formatu "IME REDAK LEKSEM".
+*/
+class Analyzer
+{
+    int it = 0;
+    int lastFound;
+    int lastRead = -1;
+    int errorAt = -1;
+    int errorStart;
+
+    int rule_f = false;
+    ID rule;
+
+    size_t size;
+    const char* input;
+
+    int rowCounter = 1;
+    bool rowCounter_u = false;
+    State state = START;
+
+    enum ErrorType {
+        UNKNOWN,
+        UNKNOWN_EXPRESSION,
+        UNKNOWN_COMMAND
+    };
+
+public:
+
+    Analyzer (const std::string& exp) : size(exp.size()), input(exp.c_str()) {}
+
+    int row() {
+        return rowCounter - rowCounter_u;
+    }
+
+    static const std::string& name(ID rule) {
+        return AUTOMATA[rule].name;
+    }
+
+    bool next_token(Token& token)
+    {
+        for (; it < size; it++)
+        {
+            bool found = false, empty = true;
+            char sym = input[it];
+
+            for (ID id : TABLE[state]) {
+                if (!AUTOMATA[id].empty()) {
+                    if (AUTOMATA[id].push_sym(sym)) {
+                        if (!found) {
+                            rule_f = true;
+                            rule = id;
+                            found = true;
+                        } else rule = std::min(rule, id);
+                    }
+                    empty &= AUTOMATA[id].empty();
+                }
+            }
+
+            if (found) lastFound = it;
+
+            if (empty)
+            {
+                bool stored = false;
+
+                if (!rule_f) {
+                    if (errorAt != row()) {
+                        errorStart = lastRead + 1;
+                        errorAt = row();
+                    }
+                    lastRead++;
+                    it = lastRead;
+                }
+                else
+                {
+                    if (errorAt != -1) {
+                        error(UNKNOWN_EXPRESSION, std::string(get_exp(errorStart, lastRead)).c_str(), errorAt);
+                        errorAt = -1;
+                    }
+
+                    it = lastFound;
+
+                    run(rule);
+                    stored = store(rule, token);
+
+                    lastRead = it;
+                    rule_f = false;
+                    rowCounter_u = false;
+                }
+
+                for (ID id : TABLE[state])
+                    AUTOMATA[id].reset();
+
+                if (stored) {
+                    it++;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void analyze()
+    {
+        Token token;
+        while (next_token(token))
+            std::cout <<name(token.rule) <<" " <<token.line <<" " <<token.lexeme <<"\n";
+        std::cout.flush();
+    }
+
+private:
+
+    void run (ID id)
+    {
+        for (const auto& command : AUTOMATA[id].commands)
+        {
+            std::string com = readNextWord(command);
+
+            if (com == "NOVI_REDAK")
+                rowCounter_u = ++rowCounter;
+            else if (com == "UDJI_U_STANJE")
+                state = readNextWord(command, 14);
+            else if (com == "VRATI_SE")
+                it = lastRead + to_int(readNextWord(command, 9));
+            else
+                error(UNKNOWN_COMMAND, com.c_str(), id);
+        }
+    }
+
+    bool store (ID id, Token& token)
+    {
+        if (AUTOMATA[id].name == "-") return false;
+        token = {id, row(), get_exp(lastRead + 1, it)};
+        return true;
+    }
+
+    std::string_view get_exp (int start, int end) {
+        if (start > end) return {};
+        return std::string_view(input + start, end - start + 1);
+    }
+
+    template <typename ...Args>
+    void error(ErrorType err, Args... args)
+    {
+        if (err == UNKNOWN_EXPRESSION)
+            std::cerr << string_format("Unknown expression: \"%s\" in line %d", args...) <<std::endl;
+        else if (err == UNKNOWN_COMMAND)
+            throw std::invalid_argument(string_format("Unknown command: \"%s\" in rule number: \"%d\"", args...));
+        else
+            throw std::invalid_argument("Unknown Exception Has occured!");
+    }
+};
+
+#ifdef EMBEDDED_TABLE
+//tablica je prevedena u program, nema čitanja ni parsiranja datoteke
+static void init([[maybe_unused]] const std::string& table = "")
+{
+    START = resources::START;
+
+    for (ID id = 0; id < resources::AUTOMATA_COUNT; id++) {
+        const resources::Automaton& atm = resources::AUTOMATA[id];
+        TABLE[atm.state].push_back(id);
+        AUTOMATA[id].name = atm.name;
+        for (ID cmd = atm.cmd_begin; cmd < atm.cmd_end; cmd++)
+            AUTOMATA[id].commands.emplace_back(resources::COMMANDS[cmd]);
+
+        if (atm.dfa >= 0) { //DKA radi izravno nad nizovima iz table.hpp
+            const resources::Dfa& dfa = resources::DFAS[atm.dfa];
+            AUTOMATA[id].deterministic = true;
+            AUTOMATA[id].dka = DKA(
+                resources::DFA_NEXT + dfa.next_begin, resources::DFA_CLASS + 256 * atm.dfa, 
+                resources::DFA_ACCEPT + dfa.accept_begin, dfa.classes
+            );
+        } else {
+            AUTOMATA[id].nka.start = atm.start;
+            AUTOMATA[id].nka.end = atm.end;
+        }
+    }
+
+    for (ID i = 0; i < resources::LINK_COUNT; i++) {
+        const resources::Link& link = resources::LINKS[i];
+        AUTOMATA[link.atm].nka.link(link.from, link.to, link.sym);
+    }
+
+    for (auto& [id, atm] : AUTOMATA)
+        if (!atm.deterministic) atm.nka.build();
+}
+#else
+static void init(const std::string& table = "table.txt")
+{
+    std::ifstream IN(table);
+
+    std::string line;
+    std::getline(IN, line);
+    START = line;
+    int id = -1;
+
+    while (getline(IN, line)) {
+        std::string prefix = consumeNextWord(line, ':');
+
+        if (prefix == "atm")
+            TABLE[readNextWord(line)].push_back(++id);
+        else if (prefix == "lnk") {
+            int a = to_int(consumeNextWord(line)), b = to_int(consumeNextWord(line)), c = std::stoi(consumeNextWord(line));
+            AUTOMATA[id].nka.link(a, b, c);
+        }
+        else if (prefix == "end")
+            AUTOMATA[id].nka.start = to_int(consumeNextWord(line)),
+            AUTOMATA[id].nka.end = to_int(consumeNextWord(line));
+        else if (prefix == "dfa") {
+            int states = to_int(consumeNextWord(line)), classes = to_int(consumeNextWord(line));
+            AUTOMATA[id].deterministic = true;
+            AUTOMATA[id].dka = DKA(states, classes);
+        }
+        else if (prefix == "cls") {
+            int c = to_int(consumeNextWord(line)), cls = to_int(consumeNextWord(line));
+            AUTOMATA[id].dka.set_class(c, cls);
+        }
+        else if (prefix == "trn") {
+            int a = to_int(consumeNextWord(line)), cls = to_int(consumeNextWord(line)), b = to_int(consumeNextWord(line));
+            AUTOMATA[id].dka.link(a, cls, b);
+        }
+        else if (prefix == "acc")
+            AUTOMATA[id].dka.set_accept(to_int(line));
+        else if (prefix == "cmd")
+            AUTOMATA[id].commands.emplace_back(line);
+        else if (prefix == "name") {
+            AUTOMATA[id].name = std::move(line);
+        }
+    }
+
+    IN.close();
+
+    for (auto& [id, atm] : AUTOMATA)
+        if (!atm.deterministic) atm.nka.build();
+}
+
+#endif
+
+}
@@ -1,213 +1,120 @@
 #include"automata.hpp"
 
-//konstructs and assigns
-
-NKA::NKA() {}
-
-#ifdef REGEX_INITIALIZABLE
-NKA::NKA(const char* str) : NKA((Regex)str) {}
-
-NKA::NKA(const std::string& str) : NKA((Regex)str) {}
-
-NKA::NKA(const Regex& regex) {
-    *this = regex;
-}
-#endif
-
-NKA::NKA(const NKA& atm) {
-    *this = atm;
-}
-NKA::NKA(NKA&& atm) noexcept {
-    *this = std::move(atm);
-}
-
-#ifdef REGEX_INITIALIZABLE
-void NKA::operator= (const char* str) {
-    *this = Regex(str);
-}
-
-void NKA::operator= (const std::string& str) {
-    *this = Regex(str);
-}
-
-void NKA::operator= (const Regex& regex) {
-    states.clear();
-    start = make_state();
-    end = parseRegex(regex, start);
-    reset();
-}
-#endif
-
-void NKA::operator= (const NKA& regex) {
-    states = regex.states;
-    start = regex.start, end = regex.end;
-    reset();
-}
-void NKA::operator= (NKA&& regex) noexcept {
-    states = std::move(regex.states);
-    start = regex.start, end = regex.end;
-    reset();
-}
+//BitNKA
+
+void BitNKA::link(ID s1, ID s2, sym s) {
+    links.emplace_back(s1, s2, s);
+    states = std::max(states, std::max(s1, s2) + 1);
+}
+
+BitNKA::Word* BitNKA::closure(ID state) {
+    return closures.data() + (size_t) state * words;
+}
+
+void BitNKA::build() {
+    states = std::max(states, std::max(start, end) + 1);
+    words = (states + 63) / 64;
+
+    std::vector<std::vector<ID>> eps(states);
+    for (const auto& [s1, s2, s] : links)
+        if (s == EPS) eps[s1].push_back(s2);
+
+    //eps okruženje svakog stanja (pretraga iz svakog stanja, automati pravila su mali)
+    closures.assign((size_t) states * words, 0);
+    std::vector<ID> stack;
+    for (ID state = 0; state < states; state++) {
+        Word* env = closure(state);
+        env[state / 64] |= Word(1) << (state % 64);
+        stack.push_back(state);
+        while (!stack.empty()) {
+            ID id = stack.back();
+            stack.pop_back();
+            for (ID n : eps[id])
+                if (!(env[n / 64] >> (n % 64) & 1)) {
+                    env[n / 64] |= Word(1) << (n % 64);
+                    stack.push_back(n);
+                }
+        }
+    }
 
-//PUBLIC members
+    moves.assign(256, {});
+    for (const auto& [s1, s2, s] : links)
+        if (s != EPS) moves[(unsigned char) s].emplace_back(s1, s2);
 
-size_t NKA::size () {
-    return states.size();
-}
+    links.clear();
+    links.shrink_to_fit();
 
-bool NKA::eval (const std::string& str) {
+    current.assign(words, 0);
+    next.assign(words, 0);
     reset();
-    bool ret;
-    for (sym s : str) ret = push_sym(s);
-    reset();
-    return ret;
-}
-
-const NKA::Set<NKA::ID>& NKA::currentState() {
-    if (stack.empty()) reset();
-    return stack.back();
 }
 
-bool NKA::push_sym (sym s) {
-    
-    stack.emplace_back(consume(currentState(), s));
-    
-    return is_accept = std::count_if(currentState().begin(), currentState().end(), 
-        [this](ID id){
-            return this->get(id).acceptable;    
-        });
-}
+bool BitNKA::push_sym (sym s) {
+    std::fill(next.begin(), next.end(), 0);
 
-void NKA::pop_sym () {
-    stack.pop_back();
-}
+    bool any = false;
+    for (const auto& [from, to] : moves[(unsigned char) s])
+        if (current[from / 64] >> (from % 64) & 1) {
+            const Word* env = closure(to);
+            for (ID w = 0; w < words; w++) next[w] |= env[w];
+            any = true;
+        }
 
-void NKA::reset() {
-    stack.clear();
-    stack.emplace_back(get_eps_neighbors(start));
+    current.swap(next);
+    is_empty = !any;
+    return any && (current[end / 64] >> (end % 64) & 1);
 }
 
-bool NKA::empty() {
-    return currentState().empty();
+bool BitNKA::empty() const {
+    return is_empty;
 }
 
-bool NKA::is_acc() {
-    return is_accept;
+void BitNKA::reset() {
+    std::copy(closure(start), closure(start) + words, current.begin());
+    is_empty = false;
 }
 
-NKA::State& NKA::get(ID id) {
-    return states[id];
-}
+const BitNKA::sym BitNKA::EPS = 0;
 
-const NKA::State& NKA::get(ID id) const {
-    return states[id];
-}
+//DKA
 
-NKA::ID NKA::make_state() {
-    states.emplace_back();
-    return states.size()-1;
+DKA::DKA(ID states, ID classes)
+    : classes(classes), own_next((size_t) states * classes, -1), own_class(256, 0), own_accept(states, 0)
+{
+    next = own_next.data();
+    class_of = own_class.data();
+    accept = own_accept.data();
 }
 
-NKA::ID NKA::add(ID state, sym s) {
-    ID next = make_state();
-    link(state, next, s);
-    return next;
-}
+DKA::DKA(const int32_t* next, const uint16_t* class_of, const uint8_t* accept, ID classes)
+    : classes(classes), next(next), class_of(class_of), accept(accept)
+{}
 
-void NKA::link(ID s1, ID s2, sym s) {
-    while (states.size() <= s1 || states.size() <= s2)
-        make_state();
-    if (s == EPS)
-        get(s1).e_neighborhood.insert(s2);
-    else 
-        get(s1).next[s].insert(s2);
+DKA::DKA(const DKA& dka) {
+    *this = dka;
 }
 
-const NKA::Set<NKA::ID>& NKA::get_transitions(ID id, sym s) {
-    if (s == EPS) return get(id).e_neighborhood;
-    else return get(id).next[s];
+DKA& DKA::operator= (const DKA& dka) {
+    classes = dka.classes;
+    current = dka.current;
+    own_next = dka.own_next;
+    own_class = dka.own_class;
+    own_accept = dka.own_accept;
+    //pokazivači na vlastite tablice moraju pokazivati na nove kopije
+    next = dka.own_next.empty() ? dka.next : own_next.data();
+    class_of = dka.own_class.empty() ? dka.class_of : own_class.data();
+    accept = dka.own_accept.empty() ? dka.accept : own_accept.data();
+    return *this;
 }
 
-NKA::Set<NKA::sym> NKA::get_transition_symbols(ID id) {
-    Set<sym> ret;
-    if (!get(id).e_neighborhood.empty()) ret.insert(EPS);
-    for (auto& p : get(id).next)
-        ret.insert(p.first);   
-    return ret;
+void DKA::set_class(unsigned char c, uint16_t cls) {
+    own_class[c] = cls;
 }
 
-//PRIVATE members
-
-const NKA::Set<NKA::ID>& NKA::get_eps_neighbors(ID state) const {
-    return get(state).e_neighborhood;
-} 
-
-NKA::Set<NKA::ID>& NKA::get_eps_neighbors(ID state) {
-
-    Set<ID>& neighborhood = get(state).e_neighborhood;
-
-    if (!get(state).evaluated) {
-        get(state).evaluated = true;
-        neighborhood = unionize(neighborhood);
-        if (neighborhood.count(end) || state == end)
-            get(state).acceptable = true;
-    }
-
-    neighborhood.insert(state);
-
-    return neighborhood;
+void DKA::link(ID s1, ID cls, ID s2) {
+    own_next[(size_t) s1 * classes + cls] = s2;
 }
 
-NKA::Set<NKA::ID> NKA::unionize (const Set<ID>& states) {
-    Set<ID> neighborhood = states;
-
-    for (ID id : states)
-        make_set_union(neighborhood, get_eps_neighbors(id));
-
-    return neighborhood;
-}
-
-NKA::Set<NKA::ID> NKA::consume(const Set<ID>& set, sym s) {
-    Set<ID> rez;
-
-    for (ID state : set) {
-        // if (state != start) remove_eps_transitions(state, s);
-        if (get(state).next.count(s))
-            make_set_union(rez, get(state).next.at(s));
-    }
-
-    return unionize(rez);
+void DKA::set_accept(ID state) {
+    own_accept[state] = 1;
 }
-
-#ifdef REGEX_INITIALIZABLE
-NKA::ID NKA::parseRegex (const Regex& regex, ID state) {
-    ID return_state;
-    
-    switch (regex.type())
-    {
-    case Regex::HAS_SEPARATOR:
-        return_state = make_state();
-        for (const Regex& r : regex) 
-            link(parseRegex(r, add(state)), return_state);
-        break;
-    case Regex::HAS_JOIN:
-        return_state = state;
-        for (const Regex& r : regex) 
-            return_state = parseRegex(r, add(return_state));
-        break;
-    case Regex::ATOMIC:
-        return_state = add(state, regex.get());
-        break;
-    }
-
-    if (regex.has_kleen()) {
-        get(return_state).kleen = true;
-        link(return_state, state);
-        return_state = state;
-    }
-    
-    return return_state;
-}
-#endif
-
-const NKA::sym NKA::EPS = 0;
\ No newline at end of file
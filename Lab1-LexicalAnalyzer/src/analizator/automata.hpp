@@ -1,7 +1,4 @@
 #pragma once
-#ifdef REGEX_INITIALIZABLE
-#include"Regex.hpp"
-#endif
 #include<map>
 #include<tuple>
 #include<unordered_set>
@@ -12,103 +9,123 @@
 #include"Utils.hpp"
 
 /*
-    Koristi push_symbol da dodaješ simbole u automat, funkcija vraća je li novo stanje prihvatljivo ili ne
-    pop_symbol se vraća u prethodno stanje, reset se vraća u početno stanje
-    eval provjerava niz znakova odjednom i vraća se u početno stanje pri završetku (vjv manje korisno)
-    name i commands su javni članovi u kojima se nalaze informacije o pravilu koje automat predstavlja
+    Automati analizatora. Generator svako pravilo zapiše ili kao DKA (ako stane u budget stanja) ili kao NKA.
+    Oba imaju isto sučelje kao i prije:
+    push_sym dodaje znak i vraća je li novo stanje prihvatljivo, empty provjerava je li automat zapeo,
+    reset vraća automat u početno stanje.
+    Automaton je omotač koji za pravilo drži ime, naredbe i jedan od ta dva automata.
 */
 
-class NKA {
+/*
+    NKA koji trenutni skup stanja drži kao bitset.
+    Za svaki znak se pamti samo popis (stanje, eps okruženje sljedećih stanja), pa korak košta
+    onoliko koliko ima prijelaza za taj znak, a unija je OR nad riječima.
+*/
+class BitNKA {
 public:
-    std::string name;
-    std::vector<std::string> commands;
-
     using ID = uint32_t;
     using sym = char;
-    template<typename T>
-    using Set = std::unordered_set<T>;
+    using Word = uint64_t;
 
     static const sym EPS;
-    ID start, end;
-    
-private:
-    struct State;
-    std::vector<State> states;
+    ID start = 0, end = 0;
 
-    mutable bool is_accept = false;
-    mutable std::vector<Set<ID>> stack;
+private:
+    ID states = 0;
+    ID words = 0;
 
-    struct State {
-        std::map<sym, Set<ID>> next;
-        Set<ID> e_neighborhood;
-        bool kleen = false;
-        bool evaluated;
-        bool optimized;
-        bool acceptable;
-    };
+    std::vector<std::tuple<ID, ID, sym>> links; //samo dok se automat ne izgradi
+    std::vector<Word> closures; //eps okruženje svakog stanja, po words riječi
+    std::vector<std::vector<std::pair<ID, ID>>> moves; //za svaki znak: (stanje, indeks okruženja u closures)
+    std::vector<Word> current, next;
+    bool is_empty = false;
 
 public:
+    void link(ID s1, ID s2, sym s = EPS);
 
-    NKA();
-
-    #ifdef REGEX_INITIALIZABLE
-    NKA(const char* str);
-
-    NKA(const std::string& str);
-
-    NKA(const Regex& regex);
+    //računa okruženja i prijelaze, zove se jednom nakon što su dodani svi prijelazi
+    void build();
 
-    void operator= (const Regex& regex);
-    void operator= (const char* str);
-    void operator= (const std::string& str);
-    #endif
+    bool push_sym (sym s);
 
-    NKA(const NKA& atm);
-    NKA(NKA&& atm) noexcept;
+    bool empty() const;
 
-    void operator= (const NKA& nka);
-    void operator= (NKA&& nka) noexcept;
+    void reset();
 
-    size_t size();
+private:
+    Word* closure(ID state);
+};
 
-    const Set<ID>& currentState();
+/*
+    DKA zapisan kao tablica next[stanje * classes + razred], razred znaka je class_of[znak].
+    Razred 0 nema prijelaza, -1 je mrtvo stanje. Tablice mogu biti vlastite (učitane iz table.txt)
+    ili pokazivati na constexpr nizove iz table.hpp.
+*/
+class DKA {
+public:
+    using ID = uint32_t;
+    using sym = char;
 
-    bool eval (const std::string& str);
+private:
+    ID classes = 1;
+    const int32_t* next = nullptr;
+    const uint16_t* class_of = nullptr;
+    const uint8_t* accept = nullptr;
+    int32_t current = 0;
 
-    bool push_sym (sym s);
+    std::vector<int32_t> own_next;
+    std::vector<uint16_t> own_class;
+    std::vector<uint8_t> own_accept;
 
-    void pop_sym ();
+public:
+    DKA() {}
 
-    const State& get(ID id) const;
+    DKA(ID states, ID classes);
 
-    ID make_state();
+    DKA(const int32_t* next, const uint16_t* class_of, const uint8_t* accept, ID classes);
 
-    ID add(ID state, sym s = EPS);
+    DKA(const DKA& dka);
+    DKA& operator= (const DKA& dka);
 
-    void link(ID s1, ID s2, sym s = EPS);
+    //samo za vlastite tablice
+    void set_class(unsigned char c, uint16_t cls);
+    void link(ID s1, ID cls, ID s2);
+    void set_accept(ID state);
 
-    bool empty();
+    inline bool push_sym (sym s) {
+        if (current < 0) return false;
+        current = next[current * classes + class_of[(unsigned char) s]];
+        return current >= 0 && accept[current];
+    }
 
-    bool is_acc();
+    inline bool empty() const {
+        return current < 0;
+    }
 
-    void reset();
+    inline void reset() {
+        current = 0;
+    }
+};
 
-    const Set<ID>& get_transitions(ID id, sym s = EPS);
-    Set<sym> get_transition_symbols(ID id);
-    
-private:
+class Automaton {
+public:
+    std::string name;
+    std::vector<std::string> commands;
 
-    State& get(ID id);
+    bool deterministic = false;
+    DKA dka;
+    BitNKA nka;
 
-    const Set<ID>& get_eps_neighbors(ID state) const;
-    
-    Set<ID>& get_eps_neighbors(ID state);
+    inline bool push_sym (char s) {
+        return deterministic ? dka.push_sym(s) : nka.push_sym(s);
+    }
 
-    Set<ID> unionize (const Set<ID>& states);
-    
-    Set<ID> consume(const Set<ID>& set, sym s);
+    inline bool empty() const {
+        return deterministic ? dka.empty() : nka.empty();
+    }
 
-    #ifdef REGEX_INITIALIZABLE
-    ID parseRegex (const Regex& regex, ID state);
-    #endif
-};
\ No newline at end of file
+    inline void reset() {
+        if (deterministic) dka.reset();
+        else nka.reset();
+    }
+};
@@ -180,7 +180,10 @@ NKA::ID NKA::parseRegex (const Regex& regex, ID state) {
     case Regex::HAS_SEPARATOR:
         return_state = make_state();
         for (const Regex& r : regex) 
-            link(parseRegex(r, add(state)), return_state);
+            if (r.type() == Regex::ATOMIC && !r.has_kleen()) //skup znakova, nema potrebe za eps granom
+                link(state, return_state, r.get());
+            else
+                link(parseRegex(r, add(state)), return_state);
         break;
     case Regex::HAS_JOIN:
         return_state = state;
@@ -202,4 +205,98 @@ NKA::ID NKA::parseRegex (const Regex& regex, ID state) {
 }
 #endif
 
-const NKA::sym NKA::EPS = 0;
\ No newline at end of file
+const NKA::sym NKA::EPS = 0;
+
+bool DKA::build(NKA& nka, size_t budget) {
+    using Subset = std::vector<ID>;
+    ID n = nka.size();
+
+    //isti prijelazi koje generator ispisuje u tablicu, tako DKA sigurno prihvaća isto što i NKA u analizatoru
+    std::vector<std::vector<ID>> eps(n);
+    std::vector<std::map<sym, std::vector<ID>>> delta(n);
+    for (ID id1 = 0; id1 < n; id1++) 
+        for (sym s : nka.get_transition_symbols(id1))
+            for (ID id2 : nka.get_transitions(id1, s))
+                if (id1 != id2) {
+                    if (s == NKA::EPS) eps[id1].push_back(id2);
+                    else delta[id1][s].push_back(id2);
+                }
+
+    std::vector<bool> visited(n);
+    auto closure = [&](std::vector<ID> stack) {
+        Subset rez;
+        for (ID id : stack) visited[id] = true;
+        while (!stack.empty()) {
+            ID id = stack.back();
+            stack.pop_back();
+            rez.push_back(id);
+            for (ID next : eps[id])
+                if (!visited[next]) {
+                    visited[next] = true;
+                    stack.push_back(next);
+                }
+        }
+        for (ID id : rez) visited[id] = false;
+        std::sort(rez.begin(), rez.end());
+        return rez;
+    };
+
+    std::map<Subset, int32_t> ids;
+    std::vector<Subset> subsets;
+    std::vector<std::map<sym, int32_t>> raw;
+
+    subsets.push_back(closure({nka.start}));
+    ids[subsets.back()] = 0;
+
+    for (size_t i = 0; i < subsets.size(); i++) 
+    {
+        std::map<sym, std::vector<ID>> moves;
+        for (ID id : subsets[i])
+            for (const auto& [s, to] : delta[id])
+                moves[s].insert(moves[s].end(), to.begin(), to.end());
+
+        raw.emplace_back();
+        for (auto& [s, to] : moves) {
+            Subset next = closure(std::move(to));
+            auto it = ids.find(next);
+            if (it == ids.end()) {
+                if (subsets.size() >= budget) return false;
+                it = ids.emplace(next, (int32_t) subsets.size()).first;
+                subsets.push_back(std::move(next));
+            }
+            raw[i][s] = it->second;
+        }
+    }
+
+    states = subsets.size();
+    accept.assign(states, false);
+    for (ID i = 0; i < states; i++)
+        accept[i] = std::binary_search(subsets[i].begin(), subsets[i].end(), nka.end);
+
+    //znakovi s istim stupcem prijelaza dobivaju isti razred
+    std::map<std::vector<int32_t>, uint16_t> columns;
+    classes.assign(256, 0);
+    class_count = 1;
+    for (int c = 0; c < 256; c++) {
+        sym s = (sym) c;
+        std::vector<int32_t> column(states, -1);
+        bool used = false;
+        for (ID i = 0; i < states; i++)
+            if (raw[i].count(s)) {
+                column[i] = raw[i].at(s);
+                used = true;
+            }
+        if (!used) continue;
+        auto it = columns.find(column);
+        if (it == columns.end())
+            it = columns.emplace(std::move(column), class_count++).first;
+        classes[c] = it->second;
+    }
+
+    next.assign(states * class_count, -1);
+    for (const auto& [column, cls] : columns)
+        for (ID i = 0; i < states; i++)
+            next[i * class_count + cls] = column[i];
+
+    return true;
+}
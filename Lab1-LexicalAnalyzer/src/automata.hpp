@@ -107,4 +107,24 @@ private:
     #ifdef REGEX_INITIALIZABLE
     ID parseRegex (const Regex& regex, ID state);
     #endif
-};
\ No newline at end of file
+};
+
+/*
+    Deterministički automat dobiven konstrukcijom podskupova iz NKA (za generator).
+    Znakovi s jednakim prijelazima u svim stanjima dijele razred, pa je tablica next veličine states * class_count.
+    Razred 0 nema nijedan prijelaz, -1 u tablici je mrtvo stanje, a početno stanje je uvijek 0.
+*/
+class DKA {
+public:
+    using ID = uint32_t;
+    using sym = NKA::sym;
+
+    ID states = 0;
+    ID class_count = 1;
+    std::vector<uint16_t> classes; //razred svakog znaka, indeks je (unsigned char)
+    std::vector<int32_t> next;
+    std::vector<bool> accept;
+
+    //gradi DKA nad prijelazima koje generator zapisuje za nka, vraća false ako treba više od budget stanja
+    bool build(NKA& nka, size_t budget);
+};
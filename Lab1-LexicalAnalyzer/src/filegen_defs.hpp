@@ -1,37 +1,48 @@
-static const std::string CPP_BEGIN = 
-R"a(#include"automata.hpp"
+/*
+    Predložak za table.hpp, tablicu analizatora zapisanu kao constexpr nizove.
+    Analizator preveden s -DEMBEDDED_TABLE ne čita table.txt nego koristi ove nizove (završe u .rodata)
+    Svaki niz ima barem jedan element na kraju (nullptr / nule) jer C++ ne dopušta prazne nizove.
+*/
+static const std::string CPP_BEGIN =
+R"a(#pragma once
+#include<cstdint>
 
-namespace resources 
+namespace resources
 {
-    using State = std::string;
-    using ID = uint32_t;
+    struct Link {
+        uint32_t atm, from, to;
+        char sym;
+    };
 
-    template<typename T>
-    using Container = std::vector<T>;
+    //dfa je indeks u DFAS ili -1 ako je pravilo ostalo NKA (start, end i LINKS vrijede samo tada)
+    struct Automaton {
+        const char* state;
+        const char* name;
+        uint32_t start, end;
+        uint32_t cmd_begin, cmd_end;
+        int32_t dfa;
+    };
 
-    static Container<State> STATES;
-    static Container<std::string> SYMBOLS;
-    static std::map<ID, NKA> AUTOMATA;
-    static std::map<State, Container<ID>> TABLE;
-    static State START;
-    
-    void init() 
-    {)a";
+    //tablica prijelaza je DFA_NEXT[next_begin + stanje * classes + razred], razred znaka je DFA_CLASS[256 * indeks + znak]
+    struct Dfa {
+        uint32_t states, classes;
+        uint32_t next_begin;
+        uint32_t accept_begin;
+    };
+)a";
 
-#define indent "        "
-#define indent2 "            "
-#define add_command(id, line) string_format("AUTOMATA[%d].commands.emplace_back(\"%s\");", id, line)
-#define add_automata(state, id) string_format("TABLE[\"%s\"].push_back(%d);", state, id)
-#define link_state(id, s1, s2, sym) string_format("AUTOMATA[%d].link(%d, %d, %d);", id, s1, s2, sym)
-#define set_name(id, name) string_format("AUTOMATA[%d].name = \"%s\";", id, name)
-#define set_start(state) string_format("START = \"%s\";", state)
-#define add_state(state) string_format("STATES.emplace_back(\"%s\");", state)
-#define add_symbol(symbol) string_format("SYMBOLS.emplace_back(\"%s\");", symbol)
-#define set_start_end(id, start, end) string_format("AUTOMATA[%d].start = %d; AUTOMATA[%d].end = %d;", id, start, id, end)
+#define indent "    "
+#define indent2 "        "
+#define set_start(state) string_format("constexpr const char* START = \"%s\";", state)
+#define begin_array(type, name) string_format("constexpr %s %s[] = {", type, name)
+#define end_array(name, count) string_format("};\n" indent "constexpr uint32_t %s_COUNT = %d;", name, count)
+#define add_link(id, s1, s2, sym) string_format("{%d, %d, %d, %d},", id, s1, s2, sym)
+#define add_automata(state, name, start, end, cmd_begin, cmd_end, dfa) string_format("{\"%s\", \"%s\", %d, %d, %d, %d, %d},", state, name, start, end, cmd_begin, cmd_end, dfa)
+#define add_dfa(states, classes, next_begin, accept_begin) string_format("{%d, %d, %d, %d},", states, classes, next_begin, accept_begin)
+#define add_command(line) string_format("\"%s\",", line)
 
-static const std::string CPP_END = 
-R"b(    }   
-})b";
+static const std::string CPP_END =
+R"b(})b";
 
 static std::string convert_to_raw (const std::string& str) {
     std::string rez = "";
@@ -40,4 +51,4 @@ static std::string convert_to_raw (const std::string& str) {
         rez += c;
     }
     return rez;
-}
\ No newline at end of file
+}
@@ -0,0 +1,163 @@
+import os
+import sys
+import json
+import glob
+import random
+import argparse
+import subprocess
+
+# Mjerenje generatora i analizatora na velikim ulazima (pokreće se iz Lab2-SyntaxAnalyzer, kao testerLA.py).
+# Za svaku gramatiku test/*/test.san se slučajnom izvedbom iz njenih produkcija napravi ispravan niz jedinki
+# otprilike zadane duljine, a rezultat (trajanja faza generatora, jedinke/s, redukcije/s, dubina stoga, RSS)
+# se ispiše kao JSON da se može uspoređivati kroz commitove.
+#   python3 benchmark.py [--tokens N] [--depth D] [--seed S] [--runs R] [--tests uzorak] [-o rezultat.json]
+
+args = argparse.ArgumentParser()
+args.add_argument("--tokens", type=int, default=200000, help="ciljana duljina ulaza u jedinkama")
+args.add_argument("--depth", type=int, default=200, help="dubina izvedbe nakon koje se biraju najkraće produkcije")
+args.add_argument("--seed", type=int, default=1)
+args.add_argument("--runs", type=int, default=3, help="za svako mjerenje se uzima najbrže od RUNS pokretanja")
+args.add_argument("--tests", default="*", help="uzorak imena direktorija u test/")
+args.add_argument("-o", "--output", default="-")
+args = args.parse_args()
+
+cwd = os.getcwd()
+src = cwd + "/src"
+analizator = src + "/analizator"
+
+subprocess.run(["g++", "generator.cpp", "-std=c++17", "-O2", "-o", "generator"], cwd=src, check=True)
+subprocess.run(["g++"] + glob.glob(analizator + "/*.cpp") + ["-std=c++17", "-O2", "-o", "analizator"], cwd=analizator, check=True)
+
+
+# %V, %T, %Syn pa blokovi "<A>" i ispod njih desne strane uvučene razmakom, "$" je epsilon
+def readGrammar(path):
+    nonterminals, productions, left = [], {}, None
+    with open(path) as file:
+        for line in file.read().splitlines():
+            if not line.strip():
+                continue
+            if line.startswith("%V"):
+                nonterminals = line.split()[1:]
+                productions = {symbol: [] for symbol in nonterminals}
+            elif line.startswith("%"):
+                continue
+            elif not line[0].isspace():
+                left = line.strip()
+            else:
+                right = [symbol for symbol in line.split() if symbol != "$"]
+                productions[left].append(right)
+    return nonterminals[0], productions
+
+
+# visina najplićeg stabla izvedenog iz svakog nezavršnog znaka, produkcije s beskonačnom visinom se ne koriste
+def minimalHeights(productions):
+    height = {symbol: float("inf") for symbol in productions}
+    changed = True
+    while changed:
+        changed = False
+        for symbol, rights in productions.items():
+            for right in rights:
+                h = 1 + max((height[s] for s in right if s in productions), default=0)
+                if h < height[symbol]:
+                    height[symbol], changed = h, True
+    return height
+
+
+# nezavršni znakovi iz kojih se može izvesti svaki nezavršni znak
+def reachable(productions):
+    reach = {symbol: {s for right in rights for s in right if s in productions} for symbol, rights in productions.items()}
+    changed = True
+    while changed:
+        changed = False
+        for symbol in reach:
+            more = set().union(*(reach[s] for s in reach[symbol])) - reach[symbol]
+            if more:
+                reach[symbol] |= more
+                changed = True
+    return reach
+
+
+# lijeva izvedba bez rekurzije: dok ulaz nije dovoljno dug i izvedba nije preduboka bira se slučajna produkcija,
+# s vjerojatnošću grow rekurzivna (ona iz koje se opet može doći do istog znaka, da ulaz raste),
+# a nakon toga ona s najmanjom visinom da izvedba završi
+def sentence(start, productions, tokens, depth, grow, rng):
+    height = minimalHeights(productions)
+    reach = reachable(productions)
+    usable = {symbol: [r for r in rights if all(height.get(s, 0) < float("inf") for s in r)]
+              for symbol, rights in productions.items()}
+    recursive = {symbol: [r for r in rights if any(s in productions and (s == symbol or symbol in reach[s]) for s in r)]
+                 for symbol, rights in usable.items()}
+    shortest = {symbol: min(rights, key=lambda r: max((height[s] for s in r if s in productions), default=0))
+                for symbol, rights in usable.items() if rights}
+
+    result, pending = [], [(start, 0)]
+    while pending:
+        symbol, level = pending.pop()
+        if symbol not in productions:
+            result.append(symbol)
+            continue
+        if len(result) + len(pending) < tokens and level < depth:
+            growing = recursive[symbol]
+            right = rng.choice(growing if growing and rng.random() < grow else usable[symbol])
+        else:
+            right = shortest[symbol]
+        pending.extend((s, level + 1) for s in reversed(right))
+    return result
+
+
+def run(command, cwd, inputFile):
+    best = None
+    for _ in range(args.runs):
+        with open(inputFile) as file:
+            done = subprocess.run(command, cwd=cwd, stdin=file, stdout=subprocess.DEVNULL,
+                                  stderr=subprocess.PIPE, text=True, check=True)
+        stats = json.loads(done.stderr.strip().splitlines()[-1])
+        key = "parse_ms" if "parse_ms" in stats else "total_ms"
+        if key == "total_ms":
+            stats[key] = sum(stats["phases_ms"].values())
+        best = stats if best is None or stats[key] < best[key] else best
+    return best
+
+
+ATTEMPTS = 10
+
+rng = random.Random(args.seed)
+results = []
+for folder in sorted(glob.glob(cwd + "/test/" + args.tests)):
+    if not os.path.exists(folder + "/test.san"):
+        continue
+
+    generator = run(["./generator", "--bin", "--stats"], src, folder + "/test.san")
+
+    # izvedba može rano završiti, pa se pokuša više puta sa sve većom sklonošću rekurziji;
+    # gramatike s konačnim jezikom ostaju s kratkim ulazom
+    start, productions = readGrammar(folder + "/test.san")
+    symbols = []
+    for attempt in range(ATTEMPTS):
+        grow = 0.7 + 0.3 * attempt / (ATTEMPTS - 1)
+        candidate = sentence(start, productions, args.tokens, args.depth, grow, rng)
+        symbols = max(symbols, candidate, key=len)
+        if len(symbols) >= args.tokens:
+            break
+    inputFile = analizator + "/benchmark.in"
+    with open(inputFile, "w") as file:
+        for i, symbol in enumerate(symbols):
+            file.write(f"{symbol} {i // 8 + 1} {symbol.lower()}\n")
+
+    analyzer = run(["./analizator", "tablica.bin", "--stats", "--tree-bin", "/dev/null"], analizator, inputFile)
+    os.remove(inputFile)
+
+    seconds = analyzer["parse_ms"] / 1000
+    analyzer["tokens_per_s"] = round(analyzer["tokens"] / seconds) if seconds else None
+    analyzer["reductions_per_s"] = round(analyzer["reductions"] / seconds) if seconds else None
+    results.append({"test": os.path.basename(folder), "generator": generator, "analyzer": analyzer})
+    print(f"{os.path.basename(folder):<16} {analyzer['tokens']:>8} jedinki  {analyzer['parse_ms']:>8.1f} ms", file=sys.stderr)
+
+commit = subprocess.run(["git", "rev-parse", "--short", "HEAD"], capture_output=True, text=True).stdout.strip()
+report = {"commit": commit, "tokens": args.tokens, "depth": args.depth, "seed": args.seed, "runs": args.runs, "tests": results}
+
+if args.output == "-":
+    print(json.dumps(report, indent=2))
+else:
+    with open(args.output, "w") as file:
+        json.dump(report, file, indent=2)
@@ -0,0 +1,51 @@
+import os
+import subprocess
+import glob
+import time
+import sys
+
+# Usporedba LR i GLR analizatora na ppjC testovima (pokreće se iz Lab2-SyntaxAnalyzer, kao testerLA.py).
+# Ulaz svakog testa se ponovi REPEAT puta (program ppjC je niz vanjskih deklaracija, pa je i ponovljen ispravan),
+# a stablo se zapisuje binarno u /dev/null da mjerenje ne bude ispis s uvlakama.
+#   python3 benchmarkGLR.py [REPEAT] [RUNS]
+
+REPEAT = int(sys.argv[1]) if len(sys.argv) > 1 else 500
+RUNS = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+cwd = os.getcwd()
+src = cwd + "/src"
+analizator = src + "/analizator"
+
+subprocess.run(["g++", "generator.cpp", "-std=c++17", "-O2", "-o", "generator"], cwd=src, check=True)
+subprocess.run(["g++"] + glob.glob(analizator + "/*.cpp") + ["-std=c++17", "-O2", "-o", "analizator"], cwd=analizator, check=True)
+
+
+def measure(args, inputFile):
+    best = None
+    for _ in range(RUNS):
+        with open(inputFile) as file:
+            start = time.perf_counter()
+            subprocess.run(["./analizator"] + args + ["--tree-bin", "/dev/null"],
+                           cwd=analizator, stdin=file, stderr=subprocess.DEVNULL, check=True)
+            elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+print(f"{'test':<16} {'tokens':>8} {'LR [ms]':>9} {'GLR [ms]':>9} {'GLR/LR':>7}")
+
+for folder in sorted(glob.glob(cwd + "/test/*ppjC*")):
+    with open(folder + "/test.san") as file:
+        subprocess.run(["./generator", "--glr"], cwd=src, stdin=file, stderr=subprocess.DEVNULL, check=True)
+
+    with open(folder + "/test.in") as file:
+        lines = file.read().splitlines()
+    inputFile = analizator + "/benchmark.in"
+    with open(inputFile, "w") as file:
+        file.write("\n".join(lines * REPEAT) + "\n")
+
+    lr = measure(["tablica.bin"], inputFile)
+    glr = measure(["tablica.bin", "--glr"], inputFile)
+    print(f"{os.path.basename(folder):<16} {len(lines) * REPEAT:>8} {lr * 1000:>9.1f} {glr * 1000:>9.1f} {glr / lr:>7.2f}")
+
+    os.remove(inputFile)
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <type_traits>
+
+/*
+    Bump alokator za čvorove stabla. Memorija se uzima u blokovima, a alokacija samo pomiče pokazivač.
+    Pojedinačnog oslobađanja nema: sve nestaje odjednom kad se arena uništi (ili clear()),
+    pa objekti u areni moraju biti trivijalno uništivi (nema destruktora koji bi se trebao zvati).
+*/
+class Arena
+{
+    static const std::size_t BLOCK = 1 << 16;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* current = nullptr;
+    std::size_t left = 0;
+
+public:
+    Arena () {}
+
+    Arena (const Arena&) = delete;
+    Arena& operator= (const Arena&) = delete;
+
+    void* allocate (std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        std::size_t padding = (align - (std::size_t) current % align) % align;
+        if (!current || padding + size > left) {
+            std::size_t blockSize = std::max(BLOCK, size + align);
+            blocks.emplace_back(new char[blockSize]);
+            current = blocks.back().get();
+            left = blockSize;
+            padding = (align - (std::size_t) current % align) % align;
+        }
+
+        void* result = current + padding;
+        current += padding + size;
+        left -= padding + size;
+        return result;
+    }
+
+    template<typename T, typename ...Args>
+    T* make (Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    template<typename T>
+    T* array (std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return count ? (T*) allocate(sizeof(T) * count, alignof(T)) : nullptr;
+    }
+
+    //kopija znakova u areni, vrijedi dok i arena
+    std::string_view copy (std::string_view str)
+    {
+        char* data = array<char>(str.size());
+        if (!str.empty()) memcpy(data, str.data(), str.size());
+        return std::string_view(data, str.size());
+    }
+
+    void clear ()
+    {
+        blocks.clear();
+        current = nullptr;
+        left = 0;
+    }
+};
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "SyntaxAnalyzer.hpp"
+#include <unordered_set>
+
+/*
+    GLR parser (Tomita) nad istom tablicom. Generator s --glr u tablica.bin ostavlja i akcije koje su izgubile
+    u konfliktima (lr::CONFLICTS), pa se na takvim ćelijama parser grana umjesto da uzme samo pobjednika.
+
+    Stog je graf (GSS): na svakoj poziciji ulaza postoji najviše jedan vrh za svako stanje, a grane koje dođu
+    u isto stanje se spajaju. Stablo je dijeljena šuma (SPPF): čvor (znak, početak) koji završava na trenutnoj
+    poziciji postoji jednom, a druge izvedbe istog dijela ulaza mu se dodaju kao dodatne (packed) izvedbe.
+    Na kraju se za svaki čvor bira izvedba s najmanje akcija koje su izgubile u konfliktima, pa je ispis isti
+    kao kod LR parsera kad god LR parser uspije bez oporavka.
+
+    Dok je vrh jedan i za njegovo stanje i trenutnu jedinku nema konflikta, parser radi kao obični LR: iznad tog vrha (base)
+    stog su dva niza stanja i čvorova kao u SyntaxAnalyzer::parse, pa se za pomak i redukciju ne alocira vrh ni veza.
+    Vrhovi za te nizove se naprave tek kad se pojavi konflikt ili redukcija koja seže ispod base, a čvorovi pozicije
+    se samo zapisuju u niz i u mapu se prebace tek ako se parser na toj poziciji grana.
+
+    Oporavka od pogreške nema: ako sve grane umru, parse vraća nullptr.
+*/
+class GLRParser
+{
+    struct Link;
+
+    struct Vertex {
+        int32_t state;
+        uint32_t level;   //broj pročitanih jedinki
+        uint32_t depth;   //najdulji put do dna, za maxDepth
+        Link* links;      //prema vrhovima ispod, najnovija prva
+    };
+
+    struct Link {
+        Vertex* to;
+        Node* node;
+        Link* next;
+    };
+
+    struct Reduction {
+        Vertex* vertex;
+        Link* via;        //ako nije nullptr, samo putevi koji počinju ovom vezom
+        int32_t production;
+        bool conflict;    //akcija je izgubila u konfliktu
+    };
+
+    struct Alternative {
+        Node** children;
+        uint32_t count;
+        bool conflict;
+    };
+
+    const LRTable& table;
+    Arena arena;
+
+    Vertex* base = nullptr;                       //dno determinističkog stoga
+    vector<int32_t> states;                       //deterministički stog iznad base, states[0] je stanje base
+    vector<Node*> values;                         //values[i] je čvor kojim se došlo u states[i], values[0] je nullptr
+    vector<Vertex*> byState;                      //vrh stanja, vrijedi samo ako mu je level trenutna pozicija
+    vector<Vertex*> heads, shifted;
+    vector<Reduction> work;
+    std::unordered_map<uint64_t, Node*> forest;   //(znak, početak) -> čvor koji završava na trenutnoj poziciji
+    vector<Node*> levelNodes;                     //čvorovi trenutne pozicije dok se parser na njoj ne grana
+    vector<Node*> path;
+    bool forked = false;
+    bool sameLevelLinks = false;                  //postoji veza unutar trenutne pozicije (epsilon redukcija)
+    Node* epsilon;
+    uint32_t level = 0;
+    int32_t terminal = 0;   //id trenutne jedinke
+
+    std::unordered_map<Node*, vector<Alternative>> packed;   //dodatne izvedbe, uz children
+    std::unordered_set<Node*> conflictPrimary;               //čvorovi čija je izvedba u children nastala iz konflikta
+
+public:
+    uint32_t ambiguities = 0, forks = 0, maxHeads = 1;
+    uint64_t tokens = 0, reductions = 0;  //kao kod SyntaxAnalyzer, redukcije se broje po putu
+    std::size_t maxDepth = 0;
+    vector<std::string_view> input;       //pročitane jedinke (kopije u areni), da se nakon neuspjeha mogu parsirati LR parserom
+
+    GLRParser (const LRTable& table) : table(table), byState(table.states, nullptr) {
+        epsilon = arena.make<Node>(0, std::string_view("$"), nullptr, 0u);
+        states.reserve(256), values.reserve(256);
+    }
+
+    GLRParser (const GLRParser&) = delete;
+    GLRParser& operator= (const GLRParser&) = delete;
+
+    // next(InputToken&) kao kod SyntaxAnalyzer::parse, stablo vrijedi dok postoji GLRParser
+    template<typename NextToken>
+    Node* parse(NextToken next)
+    {
+        InputToken token;
+        bool endReached = false;
+        auto advance = [&]() {
+            if (endReached) return false;
+            token.terminal = -1;
+            token.node = nullptr;
+            if (next(token)) {
+                tokens++;
+                token.line = arena.copy(token.line);
+                input.push_back(token.line);
+                terminal = token.terminal >= 0 ? token.terminal : table.terminal(token.symbol);
+                return true;
+            }
+            token = {"$", "$", 0};
+            terminal = 0;
+            return endReached = true;
+        };
+
+        level = 0;
+        tokens = reductions = 0;
+        maxDepth = 1;
+        input.clear();
+        heads = {vertex(0, 0)};
+        if (!advance()) return nullptr;
+
+        while (true) {
+            // deterministički dio, isto kao LR parser: stog iznad jedinog vrha su states i values
+            if (heads.size() == 1 && !forked) {
+                base = heads[0];
+                states.assign(1, base->state);
+                values.assign(1, nullptr);
+                while (true) {
+                    int32_t state = states.back();
+                    if (conflict(state)) break;
+                    int32_t action = table.action(state, terminal);
+
+                    if (lr::kind(action) == lr::REDUCIRAJ) {
+                        int32_t production = lr::value(action);
+                        uint32_t count = popLength(production);
+                        if (count >= states.size()) break;   //put ide ispod base, to radi reduceSingle
+                        std::size_t top = states.size() - count;
+                        int32_t left = table.left(production);
+                        int32_t next = table.goTo(states[top - 1], left);
+                        if (next < 0) break;
+
+                        uint32_t length = 0;
+                        for (std::size_t i = top; i < values.size(); i++) length += values[i]->length;
+                        Node* node = makeNode(left, states[top - 1], values.data() + top, count, length);
+                        levelNodes.push_back(node);
+                        reductions++;
+
+                        states.resize(top), values.resize(top);
+                        states.push_back(next), values.push_back(node);
+                        maxDepth = std::max(maxDepth, base->depth + states.size() - 1);
+                    }
+                    else if (lr::kind(action) == lr::POMAKNI) {
+                        values.push_back(leaf(token, state));
+                        states.push_back(lr::value(action));
+                        maxDepth = std::max(maxDepth, base->depth + states.size() - 1);
+                        nextLevel();
+                        if (!advance()) return nullptr;
+                    }
+                    else if (lr::kind(action) == lr::PRIHVATI)
+                        return finish(values.size() > 1 ? values.back() : base->links->node);
+                    else {
+                        cerr << "GLR: no action in state " << state << " for " << table.name(std::max(terminal, 0)) << '\n';
+                        return nullptr;
+                    }
+                }
+
+                //stog postaje lanac vrhova iznad base, pa redukcija po jedinom putu ili grananje
+                Vertex* v = heads[0] = buildStack();
+                int32_t action = table.action(v->state, terminal);
+                if (!conflict(v->state) && lr::kind(action) == lr::REDUCIRAJ && reduceSingle(v, lr::value(action))) continue;
+            }
+
+            // grananje: sve redukcije svih vrhova na ovoj poziciji, pa pomak svih vrhova
+            fork();
+            while (!work.empty()) {
+                Reduction reduction = work.back();
+                work.pop_back();
+                reducePaths(reduction);
+            }
+            maxHeads = std::max(maxHeads, (uint32_t) heads.size());
+
+            if (terminal == 0)
+                for (Vertex* v : heads)
+                    if (lr::kind(table.action(v->state, 0)) == lr::PRIHVATI) return finish(v->links->node);
+
+            shifted.clear();
+            Node* shiftedLeaf = nullptr;
+            for (Vertex* v : heads) {
+                auto shift = [&](int32_t action) {
+                    if (lr::kind(action) != lr::POMAKNI) return;
+                    int32_t state = lr::value(action);
+                    if (!shiftedLeaf) shiftedLeaf = leaf(token, v->state);
+                    Vertex* w = byState[state];
+                    if (!w || w->level != level + 1) {
+                        w = vertex(state, level + 1);
+                        shifted.push_back(w);
+                    }
+                    link(w, v, shiftedLeaf);
+                };
+                shift(table.action(v->state, terminal));
+                table.forEachConflict(v->state, terminal, shift);
+            }
+
+            if (shifted.empty()) {
+                cerr << "GLR: all branches failed at token " << level << " (" << token.line << ")\n";
+                return nullptr;
+            }
+            heads.swap(shifted);
+            nextLevel();
+            if (!advance()) return nullptr;
+        }
+    }
+
+private:
+    Vertex* vertex (int32_t state, uint32_t at)
+    {
+        Vertex* v = arena.make<Vertex>(state, at, 1u, nullptr);
+        byState[state] = v;
+        return v;
+    }
+
+    Link* link (Vertex* from, Vertex* to, Node* node)
+    {
+        Link* l = arena.make<Link>(to, node, from->links);
+        from->links = l;
+        from->depth = std::max(from->depth, to->depth + 1);
+        maxDepth = std::max<std::size_t>(maxDepth, from->depth);
+        if (to->level == level && from->level == level) sameLevelLinks = true;
+        return l;
+    }
+
+    Node* leaf (const InputToken& token, int32_t state)
+    {
+        Node* node = arena.make<Node>(terminal, token.line, nullptr, 0u);
+        node->state = state;
+        node->length = 1;
+        return node;
+    }
+
+    void nextLevel ()
+    {
+        level++;
+        if (forked) forest.clear();
+        levelNodes.clear();
+        forked = sameLevelLinks = false;
+    }
+
+    //ima li (stanje, trenutna jedinka) više akcija
+    inline bool conflict (int32_t state) const {
+        bool found = false;
+        table.forEachConflict(state, terminal, [&found](int32_t) { found = true; });
+        return found;
+    }
+
+    inline uint32_t popLength (int32_t production) const {
+        return table.isEpsilon(production) ? 0 : table.rhsLength(production);
+    }
+
+    static inline uint64_t key (int32_t symbol, uint32_t start) {
+        return (uint64_t) symbol << 32 | start;
+    }
+
+    //below je stanje ispod čvora, a length broj jedinki koje pokriva
+    Node* makeNode (int32_t left, int32_t below, Node* const* from, uint32_t count, uint32_t length)
+    {
+        Node** children;
+        if (count) {
+            children = arena.array<Node*>(count);
+            std::copy(from, from + count, children);
+        } else {
+            children = arena.array<Node*>(1);
+            children[0] = epsilon;
+        }
+        Node* node = arena.make<Node>(left, std::string_view(), children, std::max(count, 1u));
+        node->state = below;
+        node->length = length;
+        return node;
+    }
+
+    //vrhovi za deterministički stog iznad base, vraća vrh stoga
+    Vertex* buildStack ()
+    {
+        Vertex* below = base;
+        uint32_t at = base->level;
+        for (std::size_t i = 1; i < states.size(); i++) {
+            at += values[i]->length;
+            Vertex* v = vertex(states[i], at);
+            link(v, below, values[i]);
+            below = v;
+        }
+        states.resize(1), values.resize(1);
+        return below;
+    }
+
+    //jedini put, bez grananja; false ako put nije jedinstven pa redukciju mora odraditi fork
+    bool reduceSingle (Vertex* v, int32_t production)
+    {
+        uint32_t count = popLength(production);
+        path.resize(count);
+        Vertex* u = v;
+        for (uint32_t j = count; j-- > 0; ) {
+            if (!u->links || u->links->next) return false;
+            path[j] = u->links->node;
+            u = u->links->to;
+        }
+
+        int32_t left = table.left(production);
+        int32_t state = table.goTo(u->state, left);
+        if (state < 0) return false;
+
+        Node* node = makeNode(left, u->state, path.data(), count, level - u->level);
+        levelNodes.push_back(node);
+        reductions++;
+
+        Vertex* w = vertex(state, level);
+        link(w, u, node);
+        heads[0] = w;
+        return true;
+    }
+
+    void fork ()
+    {
+        if (!forked) {
+            forked = true;
+            forks++;
+            for (Node* node : levelNodes) forest.emplace(key(node->symbol, level - node->length), node);
+        }
+        for (Vertex* v : heads) enqueue(v, nullptr);
+    }
+
+    void enqueue (Vertex* v, Link* via)
+    {
+        auto add = [&](int32_t action, bool conflict) {
+            if (lr::kind(action) != lr::REDUCIRAJ) return;
+            int32_t production = lr::value(action);
+            if (via && popLength(production) == 0) return;
+            work.push_back({v, via, production, conflict});
+        };
+        add(table.action(v->state, terminal), false);
+        table.forEachConflict(v->state, terminal, [&](int32_t action) { add(action, true); });
+    }
+
+    void reducePaths (const Reduction& reduction)
+    {
+        uint32_t count = popLength(reduction.production);
+        path.resize(count);
+        if (reduction.via) {
+            path[count - 1] = reduction.via->node;
+            walk(reduction.via->to, count - 1, reduction);
+        }
+        else walk(reduction.vertex, count, reduction);
+    }
+
+    void walk (Vertex* u, uint32_t remaining, const Reduction& reduction)
+    {
+        if (remaining == 0) {
+            reduceTo(u, reduction);
+            return;
+        }
+        for (Link* l = u->links; l; l = l->next) {
+            path[remaining - 1] = l->node;
+            walk(l->to, remaining - 1, reduction);
+        }
+    }
+
+    void reduceTo (Vertex* u, const Reduction& reduction)
+    {
+        int32_t left = table.left(reduction.production);
+        int32_t state = table.goTo(u->state, left);
+        if (state < 0) return;
+        uint32_t count = path.size();
+        reductions++;
+
+        Node*& node = forest[key(left, u->level)];
+        if (!node) {
+            node = makeNode(left, u->state, path.data(), count, level - u->level);
+            if (reduction.conflict) conflictPrimary.insert(node);
+        }
+        else if (!sameDerivation(node, count)) {
+            Node* alternative = makeNode(left, u->state, path.data(), count, level - u->level);
+            packed[node].push_back({alternative->children, alternative->childCount, reduction.conflict});
+            ambiguities++;
+        }
+        Node* shared = node;
+
+        Vertex* w = byState[state];
+        if (w && w->level == level) {
+            for (Link* l = w->links; l; l = l->next)
+                if (l->to == u) return;
+            Link* l = link(w, u, shared);
+            //put kroz novu vezu može početi i u drugom vrhu ove pozicije (preko epsilon veza), pa se tada sve ponovi
+            if (sameLevelLinks) for (Vertex* v : heads) enqueue(v, nullptr);
+            else enqueue(w, l);
+        }
+        else {
+            w = vertex(state, level);
+            heads.push_back(w);
+            link(w, u, shared);
+            enqueue(w, nullptr);
+        }
+    }
+
+    bool sameDerivation (Node* node, uint32_t count) const
+    {
+        auto same = [&](Node** children, uint32_t childCount) {
+            if (count == 0) return childCount == 1 && children[0] == epsilon;
+            return childCount == count && std::equal(path.begin(), path.begin() + count, children);
+        };
+        if (same(node->children, node->childCount)) return true;
+        auto it = packed.find(node);
+        if (it != packed.end())
+            for (const Alternative& alternative : it->second)
+                if (same(alternative.children, alternative.count)) return true;
+        return false;
+    }
+
+    /*
+        Za svaki višeznačni čvor u children ide izvedba s najmanje akcija iz konflikata.
+        Šuma može imati cikluse (npr. P -> P P | $), izvedba koja vodi natrag u čvor koji se još računa ne dolazi u obzir.
+    */
+    Node* finish (Node* root)
+    {
+        if (packed.empty() && conflictPrimary.empty()) return root;
+
+        static const uint32_t CYCLE = UINT32_MAX / 2;
+        std::unordered_map<Node*, uint32_t> cost;   //CYCLE dok se čvor računa
+        vector<pair<Node*, bool>> pending = {{root, false}};
+        while (!pending.empty()) {
+            auto [node, expanded] = pending.back();
+            pending.pop_back();
+            if (node->isTerminal() || (!expanded && cost.count(node))) continue;
+
+            auto it = packed.find(node);
+            if (!expanded) {
+                cost[node] = CYCLE;
+                pending.push_back({node, true});
+                for (uint32_t i = 0; i < node->childCount; i++) pending.push_back({node->children[i], false});
+                if (it != packed.end())
+                    for (const Alternative& alternative : it->second)
+                        for (uint32_t i = 0; i < alternative.count; i++) pending.push_back({alternative.children[i], false});
+                continue;
+            }
+
+            auto costOf = [&](Node** children, uint32_t count, bool conflict) {
+                uint32_t total = conflict;
+                for (uint32_t i = 0; i < count; i++)
+                    if (!children[i]->isTerminal()) total = std::min(CYCLE, total + cost[children[i]]);
+                return total;
+            };
+            uint32_t best = costOf(node->children, node->childCount, conflictPrimary.count(node));
+            if (it != packed.end())
+                for (const Alternative& alternative : it->second) {
+                    uint32_t c = costOf(alternative.children, alternative.count, alternative.conflict);
+                    if (c < best) {
+                        best = c;
+                        node->children = alternative.children;
+                        node->childCount = alternative.count;
+                    }
+                }
+            cost[node] = best;
+        }
+        return root;
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/*
+    Tablica parsiranja kakvu koristi parser: sve je int, znakovi su id-evi
+    (0 je "$", zatim završni znakovi pa nezavršni), akcija je int s vrstom u donja dva bita.
+
+    Redak akcije i redak novog stanja su u comb (row displacement) zapisu:
+    vrijednost za (stanje, stupac) je next[base[stanje] + stupac] ako je check na tom mjestu jednak stanju,
+    a inače nema akcije (ili je to default redukcija stanja ako je generator izbacio default redukcije).
+
+    Ovo je zajedničko generatoru (koji piše tablica.bin) i analizatoru (LRTable u SyntaxAnalyzer.hpp).
+*/
+namespace lr
+{
+
+enum ActionKind : int32_t {
+    ODBACI = 0,
+    POMAKNI = 1,
+    REDUCIRAJ = 2,
+    PRIHVATI = 3
+};
+
+inline int32_t encode (ActionKind kind, int32_t value) {
+    return value << 2 | kind;
+}
+inline ActionKind kind (int32_t action) {
+    return ActionKind(action & 3);
+}
+inline int32_t value (int32_t action) {
+    return action >> 2;
+}
+
+static const char MAGIC[4] = {'L', 'R', 'T', 'B'};
+static const uint32_t VERSION = 2;
+static const uint32_t DEFAULT_REDUCTIONS = 1;
+static const uint32_t CONFLICTS = 2;
+
+/*
+    tablica.bin: Header pa redom nizovi int32 (sve little endian, poravnato na 4):
+        names_begin[symbols + 1], names[names_size] (znakovi, nadopunjeno na 4)
+        prod_left[productions], prod_begin[productions + 1], prod_rhs[rhs_size]
+        sync[sync]
+        recover[states * recoverWords(sync)]
+        default_reduce[states]
+        action_base[states], action_next[action_size], action_check[action_size]
+        goto_base[states], goto_next[goto_size], goto_check[goto_size]
+    a ako je u flags CONFLICTS (generator --glr), još i
+        conflict_count, conflicts[3 * conflict_count] (stanje, završni, akcija), sortirano po stanju pa znaku
+    što su akcije koje su izgubile pri razrješavanju konflikata (u comb je uvijek pobjednik, kao u tablica.txt).
+*/
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t states, terminals, symbols, productions, sync;
+    uint32_t action_size, goto_size, rhs_size, names_size;
+    uint32_t flags;
+};
+
+/*
+    recover je za svako stanje bitset po indeksima u sync: bit j je postavljen ako stanje ima akciju za sync[j]
+    u punoj tablici (prije default redukcija). Oporavak od pogreške traži stanje na stogu samo po ovim bitovima.
+*/
+inline uint32_t recoverWords (uint32_t sync) {
+    return (sync + 31) / 32;
+}
+
+struct Comb {
+    std::vector<int32_t> base, next, check;
+};
+
+/*
+    Pakiranje redaka (stupac, vrijednost) u comb: retci se slažu od najgušćeg, a svaki ide na prvi
+    pomak na kojem su mu sva mjesta slobodna. empty je vrijednost praznih mjesta.
+*/
+inline Comb pack (const std::vector<std::vector<std::pair<int32_t, int32_t>>>& rows, int32_t empty)
+{
+    Comb comb;
+    comb.base.assign(rows.size(), 0);
+
+    std::vector<int> order(rows.size());
+    for (int i = 0; i < (int) rows.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&rows](int a, int b) {
+        return rows[a].size() > rows[b].size();
+    });
+
+    std::size_t firstFree = 0;
+    for (int row : order)
+    {
+        if (rows[row].empty()) continue;
+
+        int32_t minCol = rows[row].front().first;
+        for (const auto& [col, val] : rows[row]) minCol = std::min(minCol, col);
+
+        for (int64_t base = (int64_t) firstFree - minCol; ; base++)
+        {
+            bool fits = true;
+            for (const auto& [col, val] : rows[row]) {
+                std::size_t at = base + col;
+                if (at < comb.check.size() && comb.check[at] != -1) { fits = false; break; }
+            }
+            if (!fits) continue;
+
+            for (const auto& [col, val] : rows[row]) {
+                std::size_t at = base + col;
+                if (at >= comb.check.size()) {
+                    comb.check.resize(at + 1, -1);
+                    comb.next.resize(at + 1, empty);
+                }
+                comb.check[at] = row;
+                comb.next[at] = val;
+            }
+            comb.base[row] = base;
+            break;
+        }
+
+        while (firstFree < comb.check.size() && comb.check[firstFree] != -1) firstFree++;
+    }
+
+    return comb;
+}
+
+}
@@ -0,0 +1,1046 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "LRFormat.hpp"
+#include "Trace.hpp"
+#include "Arena.hpp"
+#include "TreeFormat.hpp"
+
+
+using std::cerr;
+
+using std::map;
+using std::set;
+using std::vector;
+using std::pair;
+using std::string;
+
+
+/*
+    Čvor stabla, živi u Areni analizatora (nema destruktora, cijelo stablo nestaje s arenom).
+    symbol je id znaka u tablici, content redak jedinke za listove ("$" za epsilon),
+    a djeca su niz u areni zauzet jednom kad se reducira.
+    state je stanje ispod čvora na stogu (u kojem je počelo parsiranje čvora), a length broj jedinki koje pokriva,
+    to treba ponovnom parsiranju (SyntaxAnalyzer::reparse) da zna smije li čvor preuzeti cijelog.
+*/
+struct Node {
+    int32_t symbol;
+    std::string_view content;
+    Node** children;
+    uint32_t childCount;
+    int32_t state = -1;
+    uint32_t length = 0;
+
+    bool isTerminal() const {
+        return childCount == 0;
+    }
+};
+
+//tablica.txt onako kako je zapisana (znakovi i akcije kao stringovi), koristi ju samo LRTable::loadText
+class ParsingTableStuff {
+public:
+    map<pair<int, string>, pair<string, int>> akcija;
+    map<pair<int, string>, pair<string, int>> novoStanje;
+    set<string> SYNC_ZAVRSNI;
+    map<int, pair<string, vector<string>>> ID_PRODUKCIJE_MAPA;
+
+    ParsingTableStuff(const string& filename) {
+        std::ifstream in(filename);
+        string line;
+        
+        // Read SYNC_SYMBOLS
+        getline(in, line); // Read "SYNC_SYMBOLS:"
+        while (getline(in, line) && !line.empty()) {
+            SYNC_ZAVRSNI.insert(line);
+        }
+
+        // Read GRAMMAR_PRODUCTIONS:
+        getline(in, line); // "GRAMMAR_PRODUCTIONS:"
+        while (getline(in, line) && !line.empty()) {
+            int id;
+            string left;
+            vector<string> right;
+            
+            // Find positions of key elements
+            size_t space_pos = line.find(' ');
+            id = stoi(line.substr(0, space_pos));
+            
+            size_t arrow_pos = line.find("->");
+            left = line.substr(space_pos + 1, arrow_pos - space_pos - 2);
+            
+            // Get right side of production
+            string right_side = line.substr(arrow_pos + 3);
+            
+            // Split right side into symbols
+            size_t pos = 0;
+            string token;
+            while (pos < right_side.length()) {
+                size_t next_pos = right_side.find(' ', pos);
+                if (next_pos == string::npos) {
+                    token = right_side.substr(pos);
+                    if (!token.empty()) right.push_back(token);
+                    break;
+                }
+                token = right_side.substr(pos, next_pos - pos);
+                if (!token.empty()) right.push_back(token);
+                pos = next_pos + 1;
+            }
+            
+            ID_PRODUKCIJE_MAPA[id] = {left, right};
+        }
+        // std::cerr << "Grammar productions loaded" << std::endl;
+
+        // Read AKCIJA:
+        getline(in, line); // "AKCIJA:"
+        while (getline(in, line) && !line.empty()) {
+            int state;
+            string symbol;
+            pair<string, int> action;
+            
+            // Find positions of spaces
+            size_t first_space = line.find(' ');
+            size_t second_space = line.find(' ', first_space + 1);
+            
+            state = stoi(line.substr(0, first_space));
+            symbol = line.substr(first_space + 1, second_space - first_space - 1);
+            string actionString = line.substr(second_space + 1);
+            first_space = actionString.find(' ');
+            if (first_space == std::string::npos) {
+                action = {actionString, -1}; // ako je PRIHVATI stanje
+            } else {
+                action = {actionString.substr(0, first_space), stoi(actionString.substr(first_space + 1))};
+            }
+            
+            akcija[{state, symbol}] = action;
+        }
+
+        // std::cerr << "AKCIJA loaded" << std::endl;
+
+        // Read NOVO STANJE:
+        getline(in, line); // "NOVO STANJE:"
+        while (getline(in, line) && !line.empty()) {
+            int state;
+            string symbol;
+            pair<string, int> action;
+            
+            // Find positions of spaces
+            size_t first_space = line.find(' ');
+            size_t second_space = line.find(' ', first_space + 1);
+            
+            state = stoi(line.substr(0, first_space));
+            symbol = line.substr(first_space + 1, second_space - first_space - 1);
+            
+            string actionString = line.substr(second_space + 1);
+            first_space = actionString.find(' ');
+            action = {actionString.substr(0, first_space), stoi(actionString.substr(first_space + 1))};
+            
+            novoStanje[{state, symbol}] = action;
+        }
+
+        // std::cerr << "NOVO STANJE loaded" << std::endl;
+    }
+};
+
+/*
+    Tablica parsiranja za parser, sve je int (vidi LRFormat.hpp).
+    Učitava se iz tablica.bin (generator --bin), koja se samo mmapa i čita kao comb, ili iz tablica.txt
+    koja se pročita u guste nizove akcija[stanje][završni] i novo_stanje[stanje][nezavršni], pa je korak
+    parsera jedno čitanje iz niza. Format se prepoznaje po magic broju na početku datoteke.
+    Nizovi pokazuju ili u mmapanu datoteku ili u vlastite vektore, kao DKA u Lab1 analizatoru.
+*/
+class LRTable
+{
+public:
+    uint32_t states = 0, terminals = 0, symbols = 0, productions = 0;
+
+private:
+    uint32_t action_size = 0, goto_size = 0;
+
+    const int32_t *default_reduce = nullptr;
+    const int32_t *action_base = nullptr, *action_next = nullptr, *action_check = nullptr;
+    const int32_t *goto_base = nullptr, *goto_next = nullptr, *goto_check = nullptr;
+    const int32_t *dense_action = nullptr, *dense_goto = nullptr; //samo za tekstualnu tablicu
+    const int32_t *prod_left = nullptr, *prod_begin = nullptr, *prod_rhs = nullptr;
+    const int32_t *conflicts = nullptr;       //trojke (stanje, završni, akcija), vidi lr::CONFLICTS
+    std::vector<uint32_t> conflict_begin;     //prva trojka svakog stanja, prazno ako tablica nema konflikata
+
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int32_t> ids;
+    std::vector<int32_t> sync_index; //indeks završnog znaka u popisu sinkronizacijskih ili -1
+    uint32_t recover_words = 0;
+    const uint32_t* recover = nullptr;  //vidi lr::recoverWords
+
+    //vlastiti nizovi kad je tablica učitana iz teksta
+    std::vector<int32_t> own_left, own_begin, own_rhs;
+    std::vector<int32_t> own_action, own_goto;
+    std::vector<uint32_t> own_recover;
+
+    void* mapped = MAP_FAILED;
+    std::size_t mapped_size = 0;
+
+public:
+    LRTable (const std::string& filename)
+    {
+        char magic[4] = {};
+        std::ifstream(filename, std::ios::binary).read(magic, 4);
+        if (!memcmp(magic, lr::MAGIC, 4)) loadBinary(filename);
+        else loadText(filename);
+    }
+
+    LRTable (const LRTable&) = delete;
+    LRTable& operator= (const LRTable&) = delete;
+
+    ~LRTable () {
+        if (mapped != MAP_FAILED) munmap(mapped, mapped_size);
+    }
+
+    inline int32_t action (int32_t state, int32_t terminal) const
+    {
+        //oporavak od pogreške pita i za čvorove znakova na stogu (stanje -1)
+        if (state < 0 || terminal < 0) return lr::ODBACI;
+        if (dense_action) return dense_action[(std::size_t) state * terminals + terminal];
+        uint32_t at = (uint32_t) (action_base[state] + terminal);
+        if (at < action_size && action_check[at] == state) return action_next[at];
+        return default_reduce[state];
+    }
+
+    //novo stanje za nezavršni znak (id znaka, ne stupac) ili -1
+    inline int32_t goTo (int32_t state, int32_t symbol) const
+    {
+        if (state < 0) return -1;
+        if (dense_goto) return dense_goto[(std::size_t) state * (symbols - terminals) + symbol - terminals];
+        uint32_t at = (uint32_t) (goto_base[state] + symbol - (int32_t) terminals);
+        if (at < goto_size && goto_check[at] == state) return goto_next[at];
+        return -1;
+    }
+
+    //id završnog znaka ili -1 ako ga tablica ne zna
+    inline int32_t terminal (std::string_view name) const {
+        auto it = ids.find(std::string(name));
+        return it == ids.end() || it->second >= (int32_t) terminals ? -1 : it->second;
+    }
+
+    inline bool isSync (int32_t terminal) const {
+        return terminal >= 0 && sync_index[terminal] >= 0;
+    }
+
+    //ima li stanje akciju za sinkronizacijski znak, tj. može li se oporavak od pogreške nastaviti u njemu
+    inline bool canRecover (int32_t state, int32_t terminal) const {
+        if (state < 0 || !isSync(terminal)) return false;
+        uint32_t index = sync_index[terminal];
+        return recover[(std::size_t) state * recover_words + index / 32] >> (index % 32) & 1;
+    }
+
+    inline const std::string& name (int32_t symbol) const {
+        return names[symbol];
+    }
+
+    //ima li stanje akcija koje su izgubile u konfliktima (samo tablica.bin iz generator --glr)
+    inline bool hasConflicts (int32_t state) const {
+        return !conflict_begin.empty() && state >= 0 && conflict_begin[state] != conflict_begin[state + 1];
+    }
+
+    //akcije za (stanje, završni) osim one koju vraća action()
+    template<typename Action>
+    void forEachConflict (int32_t state, int32_t terminal, Action action) const {
+        if (!hasConflicts(state)) return;
+        for (uint32_t i = conflict_begin[state]; i < conflict_begin[state + 1]; i++)
+            if (conflicts[3 * i + 1] == terminal) action(conflicts[3 * i + 2]);
+    }
+
+    inline int32_t left (int32_t production) const {
+        return prod_left[production];
+    }
+
+    inline int32_t rhsLength (int32_t production) const {
+        return prod_begin[production + 1] - prod_begin[production];
+    }
+
+    inline const int32_t* rhs (int32_t production) const {
+        return prod_rhs + prod_begin[production];
+    }
+
+    //produkcija oblika A -> $
+    inline bool isEpsilon (int32_t production) const {
+        return rhsLength(production) == 1 && rhs(production)[0] == 0;
+    }
+
+private:
+    void loadBinary (const std::string& filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) < 0) throw std::runtime_error("Cannot open " + filename);
+
+        mapped_size = st.st_size;
+        mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) throw std::runtime_error("Cannot mmap " + filename);
+
+        const lr::Header& header = *(const lr::Header*) mapped;
+        if (header.version != lr::VERSION) throw std::runtime_error("Unsupported table version in " + filename);
+
+        states = header.states;
+        terminals = header.terminals;
+        symbols = header.symbols;
+        productions = header.productions;
+        action_size = header.action_size;
+        goto_size = header.goto_size;
+
+        const int32_t* at = (const int32_t*) ((const char*) mapped + sizeof(lr::Header));
+        auto take = [&at](std::size_t count) {
+            const int32_t* begin = at;
+            at += count;
+            return begin;
+        };
+
+        const int32_t* names_begin = take(symbols + 1);
+        const char* blob = (const char*) take((header.names_size + 3) / 4);
+        for (uint32_t sym = 0; sym < symbols; sym++) {
+            names.emplace_back(blob + names_begin[sym], names_begin[sym + 1] - names_begin[sym]);
+            ids[names.back()] = sym;
+        }
+
+        prod_left = take(productions);
+        prod_begin = take(productions + 1);
+        prod_rhs = take(header.rhs_size);
+
+        sync_index.assign(terminals, -1);
+        const int32_t* sync_ids = take(header.sync);
+        for (uint32_t i = 0; i < header.sync; i++) sync_index[sync_ids[i]] = i;
+        recover_words = lr::recoverWords(header.sync);
+        recover = (const uint32_t*) take((std::size_t) states * recover_words);
+
+        default_reduce = take(states);
+        action_base = take(states);
+        action_next = take(action_size);
+        action_check = take(action_size);
+        goto_base = take(states);
+        goto_next = take(goto_size);
+        goto_check = take(goto_size);
+
+        if (header.flags & lr::CONFLICTS) {
+            uint32_t count = *take(1);
+            conflicts = take(3 * (std::size_t) count);
+            conflict_begin.assign(states + 1, 0);
+            for (uint32_t i = 0; i < count; i++) conflict_begin[conflicts[3 * i] + 1]++;
+            for (uint32_t state = 0; state < states; state++) conflict_begin[state + 1] += conflict_begin[state];
+        }
+    }
+
+    //id znaka iz teksta, novi znakovi dobivaju sljedeći slobodni id
+    int32_t intern (const std::string& name)
+    {
+        auto [it, inserted] = ids.emplace(name, (int32_t) names.size());
+        if (inserted) names.push_back(name);
+        return it->second;
+    }
+
+    /*
+        tablica.txt ne razlikuje završne i nezavršne znakove, pa su završni "$", sinkronizacijski
+        znakovi i svi znakovi iz AKCIJA, a ostali su nezavršni.
+    */
+    void loadText (const std::string& filename)
+    {
+        ParsingTableStuff text(filename);
+
+        intern("$");
+        for (const auto& [key, action] : text.akcija) intern(key.second);
+        for (const string& sym : text.SYNC_ZAVRSNI) intern(sym);
+        terminals = names.size();
+        for (const auto& [key, action] : text.novoStanje) intern(key.second);
+        for (const auto& [id, production] : text.ID_PRODUKCIJE_MAPA) {
+            intern(production.first);
+            for (const string& sym : production.second) intern(sym);
+        }
+        symbols = names.size();
+
+        vector<int32_t> syncIds;
+        sync_index.assign(terminals, -1);
+        for (const string& sym : text.SYNC_ZAVRSNI) {
+            sync_index[ids.at(sym)] = syncIds.size();
+            syncIds.push_back(ids.at(sym));
+        }
+
+        productions = text.ID_PRODUKCIJE_MAPA.empty() ? 0 : text.ID_PRODUKCIJE_MAPA.rbegin()->first + 1;
+        own_left.assign(productions, 0);
+        own_begin.assign(productions + 1, 0);
+        for (int32_t id = 0; id < (int32_t) productions; id++) {
+            auto it = text.ID_PRODUKCIJE_MAPA.find(id);
+            if (it != text.ID_PRODUKCIJE_MAPA.end()) {
+                own_left[id] = ids.at(it->second.first);
+                for (const string& sym : it->second.second) own_rhs.push_back(ids.at(sym));
+            }
+            own_begin[id + 1] = own_rhs.size();
+        }
+
+        for (const auto& [key, action] : text.akcija) states = std::max(states, (uint32_t) key.first + 1);
+        for (const auto& [key, action] : text.novoStanje) states = std::max(states, (uint32_t) key.first + 1);
+
+        own_action.assign((std::size_t) states * terminals, lr::ODBACI);
+        own_goto.assign((std::size_t) states * (symbols - terminals), -1);
+        for (const auto& [key, action] : text.akcija) {
+            lr::ActionKind kind = action.first == "POMAKNI" ? lr::POMAKNI 
+                                : action.first == "REDUCIRAJ" ? lr::REDUCIRAJ 
+                                : action.first == "PRIHVATI" ? lr::PRIHVATI : lr::ODBACI;
+            own_action[(std::size_t) key.first * terminals + ids.at(key.second)] = lr::encode(kind, std::max(action.second, 0));
+        }
+        for (const auto& [key, action] : text.novoStanje)
+            own_goto[(std::size_t) key.first * (symbols - terminals) + ids.at(key.second) - terminals] = action.second;
+
+        //tekstualna tablica nema default redukcija, pa je bit za oporavak isto što i postojanje akcije
+        recover_words = lr::recoverWords(syncIds.size());
+        own_recover.assign((std::size_t) states * recover_words, 0);
+        for (uint32_t state = 0; state < states; state++)
+            for (uint32_t i = 0; i < syncIds.size(); i++)
+                if (lr::kind(own_action[(std::size_t) state * terminals + syncIds[i]]) != lr::ODBACI)
+                    own_recover[(std::size_t) state * recover_words + i / 32] |= uint32_t(1) << (i % 32);
+        recover = own_recover.data();
+
+        dense_action = own_action.data();
+        dense_goto = own_goto.data();
+        prod_left = own_left.data();
+        prod_begin = own_begin.data();
+        prod_rhs = own_rhs.data();
+    }
+};
+
+// jedinka na ulazu parsera: symbol je uniformni znak, line cijeli redak "ZNAK REDAK LEKSEM" koji ide u list stabla
+// terminal je id znaka u tablici, izvor ga može postaviti sam (npr. frontend), inače se traži po imenu
+// symbol i line pokazuju u memoriju izvora i moraju vrijediti samo do sljedećeg poziva izvora (list dobije kopiju)
+struct InputToken {
+    std::string_view symbol;
+    std::string_view line;
+    int32_t terminal = -1;
+    Node* node = nullptr; //list iz prethodnog stabla koji se preuzima umjesto nove kopije (reparse)
+};
+
+/*
+    Ulaz za ponovno parsiranje: prethodno stablo u kojem su jedinke [begin, end) zamijenjene jedinkama tokens.
+    Stablo se rastavlja lijeno, s lijeva, i samo dok treba: next() daje sljedeću jedinku (stari list ili novu jedinku),
+    a usput pamti čvorove koje je rastavio i koji počinju na toj jedinki (candidates). reuse(stanje) vraća najveći
+    od njih koji se smije preuzeti cijeli, i tada se preskoči sve što je u njemu.
+
+    Čvor se smije preuzeti ako je na vrhu stoga isto stanje kao kad je prvi put parsiran, a ni njegove jedinke
+    ni jedinka iza njega (po kojoj je reduciran) nisu dirane. LR parser je deterministički, pa bi iz tog stanja
+    nad tim jedinkama složio isto podstablo.
+*/
+class ReuseStream
+{
+    struct Entry {
+        Node* node;
+        uint32_t first; //indeks prve jedinke čvora u starom ulazu
+    };
+
+    uint32_t begin, end;
+    const vector<InputToken>& tokens;
+    std::size_t inserted = 0;
+
+    vector<Entry> pending;                         //vrh je sljedeći na ulazu
+    vector<pair<Entry, std::size_t>> candidates;   //izvana prema unutra, s veličinom pending prije rastavljanja
+
+public:
+    uint32_t reused = 0;
+
+    ReuseStream (Node* root, uint32_t begin, uint32_t end, const vector<InputToken>& tokens)
+        : begin(begin), end(end), tokens(tokens), pending{{root, 0}} {}
+
+    bool next (InputToken& token)
+    {
+        candidates.clear();
+        while (true) {
+            //nove jedinke dolaze na mjesto begin, prije svega što u starom ulazu počinje od tamo
+            if (inserted < tokens.size() && (pending.empty() || pending.back().first >= begin)) {
+                candidates.clear();
+                token = tokens[inserted++];
+                return true;
+            }
+            if (pending.empty()) return false;
+
+            Entry entry = pending.back();
+            pending.pop_back();
+            Node* node = entry.node;
+
+            if (node->isTerminal()) {
+                if (node->symbol == 0) continue; //epsilon nije jedinka
+                if (entry.first >= begin && entry.first < end) { //obrisana jedinka
+                    candidates.clear();
+                    continue;
+                }
+                token.symbol = std::string_view();
+                token.line = node->content;
+                token.terminal = node->symbol;
+                token.node = node;
+                return true;
+            }
+
+            candidates.push_back({entry, pending.size()});
+            uint32_t at = entry.first + node->length;
+            for (uint32_t i = node->childCount; i-- > 0; ) {
+                at -= node->children[i]->length;
+                pending.push_back({node->children[i], at});
+            }
+        }
+    }
+
+    Node* reuse (int32_t state)
+    {
+        for (const auto& [entry, mark] : candidates) {
+            Node* node = entry.node;
+            bool untouched = entry.first + node->length < begin || entry.first >= end;
+            if (node->length && node->state == state && untouched) {
+                pending.resize(mark);
+                candidates.clear();
+                reused++;
+                return node;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// uniformni znak je prva riječ retka "ZNAK REDAK LEKSEM"
+inline std::string_view uniformSymbol (std::string_view line)
+{
+    std::size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) begin = line.size();
+    std::size_t end = line.find_first_of(" \t\r", begin);
+    if (end == std::string_view::npos) end = line.size();
+    return line.substr(begin, end - begin);
+}
+
+/*
+    Čitanje redaka u velikim komadima (fread), redak je pogled u buffer.
+    Pogled vrijedi do sljedećeg next(), jer se tada ostatak buffera može pomaknuti na početak.
+*/
+class LineReader
+{
+    FILE* file;
+    vector<char> buffer;
+    std::size_t begin = 0, end = 0;
+    bool eof = false;
+
+public:
+    LineReader (FILE* file = stdin) : file(file), buffer(1 << 16) {}
+
+    bool next (std::string_view& line)
+    {
+        while (true) {
+            const char* newline = (const char*) memchr(buffer.data() + begin, '\n', end - begin);
+            if (newline) {
+                line = std::string_view(buffer.data() + begin, newline - buffer.data() - begin);
+                begin = newline - buffer.data() + 1;
+                return true;
+            }
+            if (eof) {
+                if (begin == end) return false;
+                line = std::string_view(buffer.data() + begin, end - begin); //zadnji redak bez '\n'
+                begin = end;
+                return true;
+            }
+
+            //nepotpuni redak ide na početak, a ako je cijeli buffer jedan redak, buffer se poveća
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            if (end == buffer.size()) buffer.resize(2 * buffer.size());
+            std::size_t got = fread(buffer.data() + end, 1, buffer.size() - end, file);
+            end += got;
+            eof = got == 0;
+        }
+    }
+};
+
+// ispis zapisa praćenja (trace::Ring::dump) u čitljivom obliku, imena znakova i produkcija su iz tablice
+inline void decodeTrace(const string& filename, const LRTable& table, std::ostream& out) {
+    uint64_t total = 0;
+    vector<trace::Record> records = trace::Ring::load(filename, total);
+    if (total > records.size())
+        out << "(" << total - records.size() << " starijih zapisa je pregaženo)\n";
+
+    auto name = [&table](int32_t symbol) -> string {
+        return symbol >= 0 && symbol < (int32_t) table.symbols ? table.name(symbol) : "?";
+    };
+
+    for (const trace::Record& rec : records) {
+        switch (rec.event) {
+        case trace::STEP:
+            out << "Vrh stoga i ulazni simbol: " << rec.state << " --- " << name(rec.symbol) << " (dubina " << rec.value << ")\n";
+            break;
+        case trace::SHIFT:
+            out << "POMAKNI " << rec.value << " (stanje " << rec.state << ", " << name(rec.symbol) << ")\n";
+            break;
+        case trace::REDUCE:
+            out << "REDUCIRAJ " << rec.value << ": " << name(rec.symbol) << " ->";
+            for (int32_t j = 0; rec.value >= 0 && j < table.rhsLength(rec.value); j++)
+                out << " " << name(table.rhs(rec.value)[j]);
+            out << "\n";
+            break;
+        case trace::GOTO:
+            out << "Goto: State " << rec.state << " with " << name(rec.symbol) << " -> " << rec.value << "\n";
+            break;
+        case trace::ACCEPT:
+            out << "PRIHVATI u stanju " << rec.state << "\n";
+            break;
+        case trace::SKIP:
+            out << "Skipping invalid input: " << name(rec.symbol) << " (stanje " << rec.state << ")\n";
+            break;
+        case trace::POP:
+            out << "Popping state " << rec.state << " during recovery (" << name(rec.symbol) << ")\n";
+            break;
+        case trace::RECOVERED:
+            out << "Recovery successful at state " << rec.state << " (" << name(rec.symbol) << ")\n";
+            break;
+        case trace::FAIL:
+            out << "Error " << rec.value << " in state " << rec.state << " at " << name(rec.symbol) << "\n";
+            break;
+        }
+    }
+}
+
+/*
+    Izlaz u velikom bufferu koji se na FILE* zapisuje s fwrite tek kad se napuni (ili na kraju).
+    Uvlake se kopiraju iz unaprijed pripremljenog niza razmaka, pa ispis retka ništa ne alocira.
+*/
+class OutputBuffer
+{
+    static const std::size_t SIZE = 1 << 16;
+
+    FILE* file;
+    vector<char> buffer;
+    std::size_t used = 0;
+    string spaces = string(256, ' ');
+
+public:
+    OutputBuffer (FILE* file = stdout) : file(file), buffer(SIZE) {}
+    ~OutputBuffer () { flush(); }
+
+    OutputBuffer (const OutputBuffer&) = delete;
+    OutputBuffer& operator= (const OutputBuffer&) = delete;
+
+    void write (const char* data, std::size_t size)
+    {
+        if (used + size > buffer.size()) {
+            flush();
+            if (size > buffer.size()) {
+                fwrite(data, 1, size, file);
+                return;
+            }
+        }
+        memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+
+    void write (std::string_view str) { write(str.data(), str.size()); }
+
+    void put (char c)
+    {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+
+    void indent (std::size_t depth)
+    {
+        if (depth > spaces.size()) spaces.resize(std::max(depth, 2 * spaces.size()), ' ');
+        write(spaces.data(), depth);
+    }
+
+    void flush ()
+    {
+        if (used) fwrite(buffer.data(), 1, used, file);
+        used = 0;
+        fflush(file);
+    }
+};
+
+class SyntaxAnalyzer {
+private:
+    const LRTable& table;
+    Arena arena; //čvorovi stabla i njihovi retci, stablo vrijedi dok postoji analizator
+    
+public:
+    trace::Ring trace; //razina je OFF (i buffer prazan) dok se ne pozove trace.setLevel
+    uint32_t errors = 0;  //preskočene jedinke i oporavci u zadnjem parsiranju
+    uint32_t reused = 0;  //podstabla preuzeta u zadnjem reparse
+    uint64_t tokens = 0, reductions = 0;  //pročitane jedinke (bez "$") i redukcije u zadnjem parsiranju
+    std::size_t maxDepth = 0;  //najveća dubina stoga u zadnjem parsiranju
+
+    //kodovi za trace::FAIL
+    enum Error {
+        STACK_EMPTY,
+        RECOVERY_FAILED,
+        STACK_UNDERFLOW,
+        NO_GOTO
+    };
+    
+    SyntaxAnalyzer(const LRTable& table) : table(table) {}
+    
+    // jedinke se čitaju sa stdin redak po redak dok parser radi, uniformni znak je prva riječ retka
+    Node* cinAndPrint() {
+        LineReader reader(stdin);
+        return parse([&](InputToken& token) {
+            if (!reader.next(token.line)) return false;
+            token.symbol = uniformSymbol(token.line);
+            return true;
+        });
+    }
+
+    /*
+        Ponovno parsiranje nakon izmjene: jedinke [begin, end) prethodnog ulaza su zamijenjene s tokens.
+        Nepromijenjena podstabla prethodnog stabla (koje mora biti iz ovog analizatora) se preuzimaju cijela,
+        pa posao ovisi o veličini izmjene, a ne ulaza. Ako prethodno parsiranje nije prošlo bez pogrešaka,
+        indeksi jedinki ne odgovaraju stablu i vraća se nullptr, pa treba parsirati cijeli ulaz ispočetka.
+    */
+    Node* reparse(Node* previous, uint32_t begin, uint32_t end, const vector<InputToken>& tokens) {
+        if (!previous || errors) return nullptr;
+        ReuseStream stream(previous, begin, end, tokens);
+        Node* root = parse(
+            [&](InputToken& token) { return stream.next(token); },
+            [&](int32_t state) { return stream.reuse(state); }
+        );
+        reused = stream.reused;
+        return root;
+    }
+
+    /*
+        Prethodno stablo za reparse iz binarnog zapisa (writeBinaryTree), umjesto da se stari ulaz parsira ispočetka.
+        Stanja i duljine čvorova se ne zapisuju, nego se izračunaju iz tablice: ispod korijena je stanje 0,
+        a svako dijete počinje u stanju u koje se iz prethodnog djeteta došlo pomakom (list) ili prijelazom.
+        Vraća nullptr ako je stablo iz druge tablice, ako je parsiranje imalo pogrešaka ili se stablo ne slaže s tablicom.
+        Listovi pokazuju u pool zapisa (ništa se ne kopira), pa zapis mora živjeti dok i stablo.
+    */
+    Node* loadTree(const tree::View& view, vector<std::string_view>& leaves) {
+        const tree::Header& header = *view.header;
+        if (header.errors || header.names != table.symbols || header.nodes == 0) return nullptr;
+        for (uint32_t symbol = 0; symbol < table.symbols; symbol++) {
+            std::size_t length;
+            const char* name = view.name(symbol, length);
+            if (std::string_view(name, length) != table.name(symbol)) return nullptr;
+        }
+
+        //svi čvorovi i sva djeca su dva niza u areni, čvorovi u preorderu kao u zapisu
+        Node* nodes = arena.array<Node>(header.nodes);
+        Node** children = arena.array<Node*>(header.nodes - 1);
+        std::size_t used = 0;
+        leaves.clear();
+
+        //roditelj je na vrhu stoga dok mu se ne popune djeca
+        vector<pair<Node*, uint32_t>> open;
+        for (uint32_t i = 0; i < header.nodes; i++) {
+            const tree::Record& record = view.nodes[i];
+            if (record.symbol < 0 || record.symbol >= (int32_t) table.symbols) return nullptr;
+            if (used + record.children > header.nodes - 1) return nullptr;
+
+            Node* node = new (nodes + i) Node{record.symbol, std::string_view(), children + used, record.children};
+            used += record.children;
+            if (!record.children) {
+                node->content = std::string_view(view.pool + record.content_begin, record.content_size);
+                if (record.symbol != 0) leaves.push_back(node->content); //epsilon nije jedinka
+            }
+
+            if (!open.empty()) {
+                auto& [parent, filled] = open.back();
+                parent->children[filled++] = node;
+                if (filled == parent->childCount) open.pop_back();
+            }
+            else if (i) return nullptr; //više korijena
+            if (record.children) open.emplace_back(node, 0);
+        }
+        if (!open.empty()) return nullptr;
+
+        //djeca su iza roditelja, pa se duljine zbrajaju unatrag
+        for (uint32_t i = header.nodes; i-- > 0; ) {
+            Node& node = nodes[i];
+            if (node.isTerminal()) node.length = node.symbol != 0;
+            else for (uint32_t c = 0; c < node.childCount; c++) node.length += node.children[c]->length;
+        }
+
+        nodes[0].state = 0;
+        for (uint32_t i = 0; i < header.nodes; i++) {
+            const Node& node = nodes[i];
+            if (node.isTerminal()) continue;
+            int32_t state = node.state;
+            for (uint32_t c = 0; c < node.childCount; c++) {
+                Node* child = node.children[c];
+                if (child->isTerminal() && child->symbol == 0) continue; //epsilon ne mijenja stanje
+                child->state = state;
+                if (child->isTerminal()) {
+                    int32_t action = child->symbol < (int32_t) table.terminals ? table.action(state, child->symbol) : lr::ODBACI;
+                    if (lr::kind(action) != lr::POMAKNI) return nullptr;
+                    state = lr::value(action);
+                }
+                else if ((state = table.goTo(state, child->symbol)) < 0) return nullptr;
+            }
+        }
+
+        errors = 0;
+        return nodes;
+    }
+
+    // next(InputToken&) vraca sljedecu jedinku ili false na kraju ulaza, "$" se dodaje automatski
+    template<typename NextToken>
+    Node* parse(NextToken next) {
+        return parse(next, [](int32_t) { return (Node*) nullptr; });
+    }
+
+    // reuse(stanje) može vratiti gotovo podstablo koje se stavlja na stog umjesto da se parsira (vidi reparse)
+    template<typename NextToken, typename Reuse>
+    Node* parse(NextToken next, Reuse reuse) {
+        //stog su dva paralelna niza: values[i] je znak (čvor) kojim se došlo u states[i], na dnu je nullptr
+        vector<int32_t> states = {0};
+        vector<Node*> values = {nullptr};
+        states.reserve(256), values.reserve(256);
+        errors = 0;
+        tokens = reductions = 0;
+        maxDepth = 1;
+
+        InputToken token;
+        int32_t terminal = 0;
+        bool endReached = false;
+        auto advance = [&]() {
+            if (endReached) return false;
+            token.terminal = -1;
+            token.node = nullptr;
+            if (next(token)) {
+                tokens++;
+                terminal = token.terminal >= 0 ? token.terminal : table.terminal(token.symbol);
+                return true;
+            }
+            token = {"$", "$", 0};
+            terminal = 0;
+            return endReached = true;
+        };
+
+        Node* rootNode = nullptr;
+        
+        bool hasToken = advance();
+        while (hasToken) {
+            if (states.empty()) {
+                TRACE(trace, ERRORS, trace::FAIL, -1, terminal, STACK_EMPTY);
+                cerr << "Error: Stack is empty\n";
+                return nullptr;
+            }
+
+            int32_t currentState = states.back();
+            TRACE(trace, STEPS, trace::STEP, currentState, terminal, (int32_t) states.size());
+
+            if (Node* subtree = reuse(currentState)) {
+                //podstablo počinje trenutnom jedinkom, pa se ulaz nastavlja iza njega
+                int32_t nextState = table.goTo(currentState, subtree->symbol);
+                if (nextState < 0) {
+                    TRACE(trace, ERRORS, trace::FAIL, currentState, subtree->symbol, NO_GOTO);
+                    cerr << "Error: No goto action found for state " << currentState 
+                        << " and symbol " << table.name(subtree->symbol) << '\n';
+                    return nullptr;
+                }
+                TRACE(trace, ACTIONS, trace::GOTO, currentState, subtree->symbol, nextState);
+                values.push_back(subtree);
+                states.push_back(nextState);
+                maxDepth = std::max(maxDepth, states.size());
+                rootNode = subtree;
+                hasToken = advance();
+                continue;
+            }
+            
+            // Look up action in parsing table
+            int32_t action = table.action(currentState, terminal);
+            if (lr::kind(action) == lr::ODBACI) {
+                // Error recovery using sync sets
+                if (table.isSync(terminal)) {
+                    // Find the topmost state that can handle this sync symbol, stog se onda skrati odjednom
+                    std::size_t depth = states.size();
+                    while (depth > 0 && !table.canRecover(states[depth - 1], terminal)) depth--;
+
+                    for (std::size_t i = states.size(); i-- > depth; )
+                        TRACE(trace, ERRORS, trace::POP, states[i], terminal);
+
+                    if (depth == 0) {
+                        TRACE(trace, ERRORS, trace::FAIL, -1, terminal, RECOVERY_FAILED);
+                        cerr << "Error recovery failed - could not find suitable state\n";
+                        return nullptr;
+                    }
+
+                    states.resize(depth);
+                    values.resize(depth);
+                    errors++;
+                    TRACE(trace, ERRORS, trace::RECOVERED, states.back(), terminal);
+                    continue;  // Try parsing again with the current symbol
+                }
+                
+                // Skip erroneous input if not a sync symbol
+                TRACE(trace, ERRORS, trace::SKIP, currentState, terminal);
+                errors++;
+                hasToken = advance();
+                continue;
+            }
+
+            int actionValue = lr::value(action);
+            
+            if (lr::kind(action) == lr::POMAKNI) {
+                TRACE(trace, ACTIONS, trace::SHIFT, currentState, terminal, actionValue);
+                
+                Node* leaf = token.node ? token.node : arena.make<Node>(terminal, arena.copy(token.line), nullptr, 0u);
+                leaf->state = currentState;
+                leaf->length = 1;
+                values.push_back(leaf);
+                states.push_back(actionValue);
+                maxDepth = std::max(maxDepth, states.size());
+                hasToken = advance();
+                
+            } else if (lr::kind(action) == lr::REDUCIRAJ) {
+                // Get production rule
+                int32_t left = table.left(actionValue);
+                TRACE(trace, ACTIONS, trace::REDUCE, currentState, left, actionValue);
+                reductions++;
+                
+                // Create new node for the reduced non-terminal, djeca su vrh stoga i kopiraju se odjednom
+                Node* newNode;
+                if(!table.isEpsilon(actionValue)){
+                    uint32_t count = table.rhsLength(actionValue);
+                    if (values.size() <= count) {
+                        TRACE(trace, ERRORS, trace::FAIL, currentState, left, STACK_UNDERFLOW);
+                        cerr << "Error: Stack underflow during reduction\n";
+                        return nullptr;
+                    }
+
+                    std::size_t base = values.size() - count;
+                    Node** children = arena.array<Node*>(count);
+                    std::copy(values.begin() + base, values.end(), children);
+                    values.resize(base);
+                    states.resize(base);
+                    newNode = arena.make<Node>(left, std::string_view(), children, count);
+                    for (uint32_t i = 0; i < count; i++) newNode->length += children[i]->length;
+                }
+                else{
+                    Node** children = arena.array<Node*>(1);
+                    children[0] = arena.make<Node>(0, std::string_view("$"), nullptr, 0u);
+                    newNode = arena.make<Node>(left, std::string_view(), children, 1u);
+                }
+                newNode->state = states.back();
+                
+                // Look up goto action
+                int32_t nextState = table.goTo(states.back(), left);
+                if (nextState < 0) {
+                    TRACE(trace, ERRORS, trace::FAIL, states.back(), left, NO_GOTO);
+                    cerr << "Error: No goto action found for state " << states.back() 
+                        << " and symbol " << table.name(left) << '\n';
+                    return nullptr;
+                }
+                
+                TRACE(trace, ACTIONS, trace::GOTO, states.back(), left, nextState);
+                
+                values.push_back(newNode);
+                states.push_back(nextState);
+                maxDepth = std::max(maxDepth, states.size()); //epsilon redukcija produbljuje stog
+                
+                rootNode = newNode;
+                
+            } else {
+                TRACE(trace, ACTIONS, trace::ACCEPT, currentState);
+                return rootNode;
+            }
+        }
+
+        cerr << "Warning: Reached end of input without explicit accept\n";
+        return rootNode;
+    }
+
+    //ispis stabla u preorderu, bez rekurzije (duge lijevo rekurzivne liste ne smiju srušiti stog programa)
+    void printFromRoot(Node* root, FILE* file = stdout) {
+        if (!root) return;  // Add this check to prevent segmentation fault
+        std::cout.flush();
+
+        OutputBuffer out(file);
+        vector<pair<Node*, uint32_t>> pending = {{root, 0}};
+        while (!pending.empty()) {
+            auto [node, depth] = pending.back();
+            pending.pop_back();
+
+            out.indent(depth);
+            out.write(node->isTerminal() ? node->content : std::string_view(table.name(node->symbol)));
+            out.put('\n');
+
+            // djeca idu na stog obrnutim redom da prvo dijete bude na vrhu
+            for (uint32_t i = node->childCount; i-- > 0; )
+                pending.emplace_back(node->children[i], depth + 1);
+        }
+    }
+
+    //isto stablo u binarnom zapisu (TreeFormat.hpp) koji Lab3 čita bez parsiranja
+    void writeBinaryTree(Node* root, FILE* file) {
+        if (!root) return;
+
+        vector<tree::Record> nodes;
+        string pool;
+        vector<Node*> pending = {root};
+        while (!pending.empty()) {
+            Node* node = pending.back();
+            pending.pop_back();
+
+            tree::Record record = {node->symbol, node->childCount, -1, 0, 0, 0, 0};
+            if (node->isTerminal()) {
+                //redak jedinke je "IME REDAK LEKSEM", za epsilon samo "$"
+                std::string_view content = node->content;
+                record.content_begin = pool.size();
+                record.content_size = content.size();
+
+                std::size_t lineBegin = content.find(' ');
+                if (lineBegin != std::string_view::npos) {
+                    std::size_t unitBegin = content.find(' ', lineBegin + 1);
+                    record.line = std::atoi(string(content.substr(lineBegin + 1, unitBegin - lineBegin - 1)).c_str());
+                    if (unitBegin != std::string_view::npos) {
+                        std::size_t unitEnd = content.find(' ', unitBegin + 1);
+                        if (unitEnd == std::string_view::npos) unitEnd = content.size();
+                        record.unit_begin = record.content_begin + unitBegin + 1;
+                        record.unit_size = unitEnd - unitBegin - 1;
+                    }
+                }
+                pool.append(content);
+            }
+            nodes.push_back(record);
+
+            for (uint32_t i = node->childCount; i-- > 0; )
+                pending.push_back(node->children[i]);
+        }
+
+        vector<uint32_t> namesBegin = {0};
+        string names;
+        for (uint32_t symbol = 0; symbol < table.symbols; symbol++) {
+            names += table.name(symbol);
+            namesBegin.push_back(names.size());
+        }
+        names.resize(tree::align4(names.size()), '\0');
+
+        tree::Header header;
+        memcpy(header.magic, tree::MAGIC, 4);
+        header.version = tree::VERSION;
+        header.nodes = nodes.size();
+        header.names = table.symbols;
+        header.names_size = namesBegin.back();
+        header.pool_size = pool.size();
+        header.errors = errors;
+
+        std::cout.flush();
+        OutputBuffer out(file);
+        out.write((const char*) &header, sizeof(header));
+        out.write((const char*) namesBegin.data(), sizeof(uint32_t) * namesBegin.size());
+        out.write(names);
+        out.write((const char*) nodes.data(), sizeof(tree::Record) * nodes.size());
+        out.write(pool);
+    }
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+
+/*
+    Praćenje rada parsera. Umjesto ispisa na cerr svaki događaj je zapis fiksne veličine u prstenastom
+    bufferu (kad se napuni, najstariji zapisi se pregaze). Buffer se na kraju zapiše u datoteku, a tekst
+    se iz nje dobije tek naknadno (./analizator --decode trace.bin [tablica]), pa praćenje dok parsira
+    košta jednu usporedbu razine i par spremanja u memoriju.
+
+    Razina se bira pri pokretanju (--trace N), a ako se prevede s -DNO_TRACE, TRACE makro se potpuno izbaci.
+*/
+namespace trace
+{
+
+enum Level : uint8_t {
+    OFF = 0,
+    ERRORS = 1,   //oporavak od pogreške i greške
+    ACTIONS = 2,  //pomakni, reduciraj, stavi, prihvati
+    STEPS = 3     //i svaki korak parsera (stanje, ulazni znak, dubina stoga)
+};
+
+enum Event : uint8_t {
+    STEP,       //stanje, znak, dubina stoga
+    SHIFT,      //stanje, znak, novo stanje
+    REDUCE,     //stanje, lijeva strana, produkcija
+    GOTO,       //stanje, nezavršni znak, novo stanje
+    ACCEPT,     //stanje
+    SKIP,       //stanje, znak koji se preskače
+    POP,        //stanje koje se skida tijekom oporavka, sinkronizacijski znak
+    RECOVERED,  //stanje u kojem se nastavlja, sinkronizacijski znak
+    FAIL        //stanje, znak, kod greške
+};
+
+struct Record {
+    Event event;
+    uint8_t pad[3];
+    int32_t state, symbol, value;
+};
+
+static const char MAGIC[4] = {'L', 'R', 'T', 'R'};
+
+class Ring
+{
+    std::vector<Record> buffer;
+    std::size_t capacity;
+    uint64_t count = 0;
+    Level current = OFF;
+
+public:
+    //kapacitet mora biti potencija broja 2, buffer se alocira tek kad se praćenje uključi
+    Ring (std::size_t capacity = 1 << 16) : capacity(capacity) {}
+
+    inline Level level () const {
+        return current;
+    }
+
+    void setLevel (Level level) {
+        if (level != OFF && buffer.empty()) buffer.resize(capacity);
+        current = level;
+    }
+
+    inline void record (Event event, int32_t state, int32_t symbol = -1, int32_t value = -1) {
+        Record& rec = buffer[count++ & (buffer.size() - 1)];
+        rec.event = event;
+        rec.state = state;
+        rec.symbol = symbol;
+        rec.value = value;
+    }
+
+    //zapisi od najstarijeg prema najnovijem
+    void dump (const std::string& filename) const
+    {
+        std::ofstream out(filename, std::ios::binary);
+        uint64_t kept = std::min<uint64_t>(count, buffer.size());
+        out.write(MAGIC, 4);
+        out.write((const char*) &count, sizeof(count));
+        out.write((const char*) &kept, sizeof(kept));
+        for (uint64_t i = count - kept; i < count; i++)
+            out.write((const char*) &buffer[i & (buffer.size() - 1)], sizeof(Record));
+    }
+
+    static std::vector<Record> load (const std::string& filename, uint64_t& total)
+    {
+        std::ifstream in(filename, std::ios::binary);
+        char magic[4] = {};
+        uint64_t kept = 0;
+        in.read(magic, 4);
+        if (memcmp(magic, MAGIC, 4)) return {};
+        in.read((char*) &total, sizeof(total));
+        in.read((char*) &kept, sizeof(kept));
+
+        std::vector<Record> records(kept);
+        in.read((char*) records.data(), kept * sizeof(Record));
+        return records;
+    }
+};
+
+}
+
+#ifdef NO_TRACE
+#define TRACE(ring, lvl, ...) ((void) 0)
+#else
+#define TRACE(ring, lvl, ...) do { if ((ring).level() >= trace::lvl) (ring).record(__VA_ARGS__); } while (0)
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/*
+    Binarni zapis generativnog stabla, zamjena za ispis s uvlakama između Lab2 i Lab3.
+    Čvorovi su u preorderu (isti redoslijed kao tekstualni ispis), svaki zna koliko ima djece,
+    pa se stablo složi jednim prolazom bez brojanja razmaka i rezanja redaka.
+
+    Datoteka: Header pa redom (sve little endian, poravnato na 4):
+        names_begin[names + 1], names[names_size] (znakovi, nadopunjeno na 4)
+        nodes[nodes] (Record)
+        pool[pool_size] (retci listova, npr. "IDN 3 x", i "$" za epsilon)
+
+    Za list content je cijeli redak, a unit prva riječ iza broja retka (onako kako ju Lab3 dobije s consumeNextWord).
+    line je -1 za nezavršne znakove i epsilon.
+    errors je broj pogrešaka (oporavaka i preskočenih jedinki) pri parsiranju, stablo s pogreškama se ne može
+    koristiti kao prethodno stablo za ponovno parsiranje (analizator --reparse).
+
+    Ovo je zajedničko analizatoru iz Lab2 (koji piše) i Lab3 (koji čita).
+*/
+namespace tree
+{
+
+static const char MAGIC[4] = {'L', 'R', 'S', 'T'};
+static const uint32_t VERSION = 2;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodes, names, names_size, pool_size;
+    uint32_t errors;
+};
+
+struct Record {
+    int32_t symbol;
+    uint32_t children;
+    int32_t line;
+    uint32_t content_begin, content_size;
+    uint32_t unit_begin, unit_size;
+};
+
+inline std::size_t align4 (std::size_t size) {
+    return (size + 3) & ~std::size_t(3);
+}
+
+//pogled na zapis u memoriji (npr. mmap-ana datoteka), ništa se ne kopira
+struct View {
+    const Header* header = nullptr;
+    const uint32_t* names_begin = nullptr;
+    const char* names = nullptr;
+    const Record* nodes = nullptr;
+    const char* pool = nullptr;
+
+    //false ako podaci nisu stablo u ovom formatu
+    bool load (const char* data, std::size_t size)
+    {
+        if (size < sizeof(Header) || memcmp(data, MAGIC, 4)) return false;
+        header = (const Header*) data;
+        if (header->version != VERSION) return false;
+
+        const char* it = data + sizeof(Header);
+        names_begin = (const uint32_t*) it;
+        it += sizeof(uint32_t) * (header->names + 1);
+        names = it;
+        it += align4(header->names_size);
+        nodes = (const Record*) it;
+        it += sizeof(Record) * header->nodes;
+        pool = it;
+        return it + header->pool_size <= data + size;
+    }
+
+    inline const char* name (int32_t symbol, std::size_t& length) const {
+        length = names_begin[symbol + 1] - names_begin[symbol];
+        return names + names_begin[symbol];
+    }
+};
+
+}
@@ -1,416 +1,165 @@
-#include <map>
-#include <set>
-#include <vector>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <iostream>
-#include <stack>
-
-
-using std::cerr;
-
-using std::map;
-using std::set;
-using std::vector;
-using std::pair;
-using std::string;
-using std::stack;
-
-using Symbol = std::string;
-using State = int;
-using Action = std::pair<string, int>;
-
-using Word = vector<Symbol>;
-
-
-
-struct Node {
-public:
-    string symbol;
-    int state;
-    vector<Node*> children;
-    string content;
-
-    Node(){
-        symbol = "";
-        state = -1;
-        children = {};
-        content = "";
-    }
-
-    Node(const string& sym) 
-        : symbol(sym), state(-1), children({}), content("") {}
-    Node(const string& sym, const string& cont) 
-        : symbol(sym), state(-1), children({}), content(cont) {}
-    Node(const int& st) 
-        : symbol(""), state(st), children({}), content("") {}
-    
-    ~Node() {
-        for (auto child : children) {
-            delete child;
-        }
+#include "SyntaxAnalyzer.hpp"
+#include "GLR.hpp"
+#include <chrono>
+#include <sys/resource.h>
+
+/*
+    ./analizator [tablica.txt | tablica.bin] [--trace N] [--trace-file trace.bin] [--tree-bin stablo.bin] < ulaz
+    ./analizator --decode trace.bin [tablica]
+    ./analizator [tablica] --tree-bin stari.bin < stari.in
+    ./analizator [tablica] --reparse stari.bin < novi.in
+    ./analizator tablica.bin --glr < ulaz
+    ./analizator [tablica] --stats < ulaz
+
+    --trace N       razina praćenja (1 oporavak, 2 akcije, 3 svaki korak), zapisi idu u --trace-file
+    --decode        ispisuje zapise praćenja kao tekst
+    --tree-bin      stablo se umjesto ispisa s uvlakama zapiše binarno (TreeFormat.hpp), "-" je stdout
+    --reparse       učita stablo starog ulaza (binarni zapis iz --tree-bin) i novi ulaz (stdin) ponovno parsira samo oko razlike,
+                    preuzimajući ostatak starog stabla; ako staro stablo ima pogreške, novi ulaz se parsira cijeli.
+                    Učitavanje zapisa je linearno u veličini stabla, pa je ukupno otprilike koliko i puno parsiranje:
+                    naredba samo pokazuje SyntaxAnalyzer::reparse, a dobitak je kad staro stablo već živi u memoriji (editor, frontend)
+    --glr           GLR parser (GLR.hpp) nad tablicom iz generator --glr; ako ne uspije, ulaz se parsira LR parserom s oporavkom
+    --stats         na kraju na cerr ispisuje JSON redak: jedinke, redukcije, najveća dubina stoga, pogreške,
+                    preuzeta podstabla (--reparse), trajanje parsiranja (zajedno s čitanjem ulaza) i ispisa u ms te najveći RSS procesa u KB (za benchmark.py)
+*/
+// cijeli ulaz u jedan buffer, a retci su pogledi u njega (bez '\n')
+static vector<std::string_view> readLines(FILE* file, string& buffer) {
+    char chunk[1 << 16];
+    for (std::size_t got; (got = fread(chunk, 1, sizeof(chunk), file)) > 0; ) buffer.append(chunk, got);
+
+    vector<std::string_view> lines;
+    std::string_view rest = buffer;
+    while (!rest.empty()) {
+        std::size_t newline = rest.find('\n');
+        lines.push_back(rest.substr(0, newline));
+        rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
     }
-
-    bool isTerminal() const {
-        return children.empty();
-    }
-};
-
-
-void printStackDebug(const stack<Node*>& s) {
-    // We need to make a copy since we can't iterate a stack directly
-    stack<Node*> temp = s;
-    vector<string> elements;
-    
-    // Store elements in reverse order (since stack prints from top)
-    while (!temp.empty()) {
-        Node* node = temp.top();
-        if (node->state != -1) {
-            elements.push_back(std::to_string(node->state));
-        } else {
-            elements.push_back(node->symbol);
-        }
-        temp.pop();
-    }
-    
-    // Print header
-    cerr << "\n=== Stack Bottom ===\n";
-    
-    // Print in correct order (bottom to top)
-    for (int i = elements.size() - 1; i >= 0; i--) {
-        cerr << elements[i] << " ";
-    }
-    cerr << "\n";
-    
-    cerr << "=== Stack Top ===\n\n";
+    return lines;
 }
 
-class ParsingTableStuff {
-public:
-    map<pair<int, Symbol>, Action> akcija;      
-    map<pair<int, Symbol>, Action> novoStanje;  
-    set<Symbol> SYNC_ZAVRSNI;
-    map<int, pair<Symbol, Word>> ID_PRODUKCIJE_MAPA;
-
-    ParsingTableStuff(const string& filename) {
-        std::ifstream in(filename);
-        string line;
-        
-        // Read SYNC_SYMBOLS
-        getline(in, line); // Read "SYNC_SYMBOLS:"
-        while (getline(in, line) && !line.empty()) {
-            SYNC_ZAVRSNI.insert(line);
-        }
-
-        // Read GRAMMAR_PRODUCTIONS:
-        getline(in, line); // "GRAMMAR_PRODUCTIONS:"
-        while (getline(in, line) && !line.empty()) {
-            int id;
-            Symbol left;
-            Word right;
-            
-            // Find positions of key elements
-            size_t space_pos = line.find(' ');
-            id = stoi(line.substr(0, space_pos));
-            
-            size_t arrow_pos = line.find("->");
-            left = line.substr(space_pos + 1, arrow_pos - space_pos - 2);
-            
-            // Get right side of production
-            string right_side = line.substr(arrow_pos + 3);
-            
-            // Split right side into symbols
-            size_t pos = 0;
-            string token;
-            while (pos < right_side.length()) {
-                size_t next_pos = right_side.find(' ', pos);
-                if (next_pos == string::npos) {
-                    token = right_side.substr(pos);
-                    if (!token.empty()) right.push_back(token);
-                    break;
-                }
-                token = right_side.substr(pos, next_pos - pos);
-                if (!token.empty()) right.push_back(token);
-                pos = next_pos + 1;
-            }
-            
-            ID_PRODUKCIJE_MAPA[id] = {left, right};
-        }
-        // std::cerr << "Grammar productions loaded" << std::endl;
+static Node* parseLines(SyntaxAnalyzer& analyzer, const vector<std::string_view>& lines, std::size_t from, std::size_t to) {
+    return analyzer.parse([&](InputToken& token) {
+        if (from == to) return false;
+        token.line = lines[from++];
+        token.symbol = uniformSymbol(token.line);
+        return true;
+    });
+}
 
-        // Read AKCIJA:
-        getline(in, line); // "AKCIJA:"
-        while (getline(in, line) && !line.empty()) {
-            int state;
-            Symbol symbol;
-            Action action;
-            
-            // Find positions of spaces
-            size_t first_space = line.find(' ');
-            size_t second_space = line.find(' ', first_space + 1);
-            
-            state = stoi(line.substr(0, first_space));
-            symbol = line.substr(first_space + 1, second_space - first_space - 1);
-            string actionString = line.substr(second_space + 1);
-            first_space = actionString.find(' ');
-            if (first_space == std::string::npos) {
-                action = {actionString, -1}; // ako je PRIHVATI stanje
-            } else {
-                action = {actionString.substr(0, first_space), stoi(actionString.substr(first_space + 1))};
-            }
-            
-            akcija[{state, symbol}] = action;
-        }
+// razlika je jedan blok: zajednički početak i kraj ostaju, a sve između se zamijeni.
+// Prethodno stablo je binarni zapis (--tree-bin) starog ulaza, a stari ulaz su njegovi listovi.
+// Listovi učitanog stabla pokazuju u mmapani zapis, pa se on ne odmapira (živi do kraja programa kao i stablo).
+static Node* reparse(SyntaxAnalyzer& analyzer, const string& previousFile, string& input) {
+    int fd = open(previousFile.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + previousFile);
+    struct stat st;
+    fstat(fd, &st);
+    void* data = st.st_size ? mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    vector<std::string_view> after = readLines(stdin, input);
+
+    tree::View view;
+    vector<std::string_view> before;
+    Node* previous = data != MAP_FAILED && view.load((const char*) data, st.st_size) ? analyzer.loadTree(view, before) : nullptr;
+    if (!previous) return parseLines(analyzer, after, 0, after.size()); //staro stablo ima pogreške ili je iz druge tablice
+
+    std::size_t prefix = 0, suffix = 0;
+    while (prefix < before.size() && prefix < after.size() && before[prefix] == after[prefix]) prefix++;
+    while (suffix < before.size() - prefix && suffix < after.size() - prefix
+        && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) suffix++;
+
+    vector<InputToken> tokens;
+    for (std::size_t i = prefix; i < after.size() - suffix; i++)
+        tokens.push_back({uniformSymbol(after[i]), after[i]});
+
+    Node* root = analyzer.reparse(previous, prefix, before.size() - suffix, tokens);
+    if (!root) root = parseLines(analyzer, after, 0, after.size());
+    return root;
+}
 
-        // std::cerr << "AKCIJA loaded" << std::endl;
+int main(int argc, char** argv) {
+    string tablePath = "tablica.txt", traceFile = "trace.bin", decodeFile = "", treeFile = "", previousFile = "";
+    int traceLevel = trace::OFF;
+    bool glr = false, stats = false;
+
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) traceLevel = std::stoi(argv[++i]);
+        else if (arg == "--trace-file" && i + 1 < argc) traceFile = argv[++i];
+        else if (arg == "--decode" && i + 1 < argc) decodeFile = argv[++i];
+        else if (arg == "--tree-bin" && i + 1 < argc) treeFile = argv[++i];
+        else if (arg == "--reparse" && i + 1 < argc) previousFile = argv[++i];
+        else if (arg == "--glr") glr = true;
+        else if (arg == "--stats") stats = true;
+        else positional.push_back(arg);
+    }
+    if (!positional.empty()) tablePath = positional[0];
 
-        // Read NOVO STANJE:
-        getline(in, line); // "NOVO STANJE:"
-        while (getline(in, line) && !line.empty()) {
-            int state;
-            Symbol symbol;
-            Action action;
-            
-            // Find positions of spaces
-            size_t first_space = line.find(' ');
-            size_t second_space = line.find(' ', first_space + 1);
-            
-            state = stoi(line.substr(0, first_space));
-            symbol = line.substr(first_space + 1, second_space - first_space - 1);
-            
-            string actionString = line.substr(second_space + 1);
-            first_space = actionString.find(' ');
-            action = {actionString.substr(0, first_space), stoi(actionString.substr(first_space + 1))};
-            
-            novoStanje[{state, symbol}] = action;
-        }
+    LRTable table(tablePath);
 
-        // std::cerr << "NOVO STANJE loaded" << std::endl;
+    if (!decodeFile.empty()) {
+        decodeTrace(decodeFile, table, std::cout);
+        return 0;
     }
 
-    // Debug function to verify loaded data
-    void printLoaded() const {
-        std::cerr << "SYNC_SYMBOLS:\n";
-        for (const auto& sym : SYNC_ZAVRSNI) {
-            std::cerr << sym << "\n";
-        }
-        std::cerr << "\nGRAMMAR_PRODUCTIONS:\n";
-        for (const auto& [id, prod] : ID_PRODUKCIJE_MAPA) {
-            std::cerr << id << ", " << prod.first << " :== ";
-            for (const auto& s : prod.second) {
-                std::cerr << s << ", ";
-            }
-            std::cerr << "\n";
-        }
-        std::cerr << "\nAKCIJA:\n";
-        for (const auto& [key, value] : akcija) {
-            std::cerr << key.first << ", " << key.second << ", " << value.first << ", " << value.second << "\n";
-        }
-        std::cerr << "\nNOVO STANJE:\n";
-        for (const auto& [key, value] : novoStanje) {
-            std::cerr << key.first << ", " << key.second << ", " << value.first << ", " << value.second << "\n";
+    SyntaxAnalyzer analyzer(table);
+    analyzer.trace.setLevel((trace::Level) traceLevel);
+    GLRParser glrParser(table);
+    Node* root;
+    auto start = std::chrono::steady_clock::now();
+    string input; //novi ulaz za --reparse, stablo pokazuje u njega
+    if (glr) {
+        LineReader reader(stdin);
+        auto next = [&](InputToken& token) {
+            if (!reader.next(token.line)) return false;
+            token.symbol = uniformSymbol(token.line);
+            return true;
+        };
+        root = glrParser.parse(next);
+        if (glrParser.ambiguities)
+            cerr << "GLR: " << glrParser.ambiguities << " dodatnih izvedbi, ispisana je ona s najmanje akcija iz konflikata\n";
+        if (!root) {
+            //GLR parser je stao negdje u ulazu, LR parser ponovno čita ono što je GLR već pročitao pa ostatak
+            std::size_t at = 0;
+            root = analyzer.parse([&](InputToken& token) {
+                if (at == glrParser.input.size()) return next(token);
+                token.line = glrParser.input[at++];
+                token.symbol = uniformSymbol(token.line);
+                return true;
+            });
+            glr = false;
         }
     }
-};
-
-class SyntaxAnalyzer {
-private:
-    const ParsingTableStuff& table;
-    
-public:
-    
-    SyntaxAnalyzer(const ParsingTableStuff& table) : table(table) {}
-    
-    Node* cinAndPrint() {
-        stack<Node*> nodeStack;
-        nodeStack.emplace(new Node(0));
-
-        string inputLineTemp;
-        vector<string> inputLines;
-        while(getline(std::cin, inputLineTemp)) {
-            inputLines.push_back(inputLineTemp);
-            cerr << "Line: " << inputLineTemp << '\n';
-        }
-
-        inputLines.push_back("$");
-        Node* rootNode = nullptr;
-        
-        int i = 0;
-        while (i < inputLines.size()) {
-            printStackDebug(nodeStack);
-            
-            if (nodeStack.empty()) {
-                cerr << "Error: Stack is empty\n";
-                return nullptr;
-            }
-
-            string inputLine = inputLines[i];
-            std::istringstream iss(inputLine);
-            string symbol;
-            iss >> symbol;
-            
-            Node* currentState = nodeStack.top();
-            cerr << "Vrh stoga i ulazni simbol: " << currentState->state << " --- " << symbol << '\n';
-            
-            // Look up action in parsing table
-            auto actionIt = table.akcija.find({currentState->state, symbol});
-            if (actionIt == table.akcija.end()) {
-                cerr << "Error recovery: No action defined for state " << currentState->state 
-                    << " and symbol " << symbol << '\n';
-                
-                // Error recovery using sync sets
-                if (table.SYNC_ZAVRSNI.find(symbol) != table.SYNC_ZAVRSNI.end()) {
-                    cerr << "Found sync symbol '" << symbol << "', attempting recovery...\n";
-                    
-                    // Pop states until we find one that can handle this sync symbol
-                    bool recovered = false;
-                    while (!nodeStack.empty()) {
-                        Node* state = nodeStack.top();
-                        auto recoveryAction = table.akcija.find({state->state, symbol});
-                        if (recoveryAction != table.akcija.end()) {
-                            cerr << "Recovery successful at state " << state->state << '\n';
-                            recovered = true;
-                            break;
-                        }
-                        cerr << "Popping state " << state->state << " during recovery\n";
-                        nodeStack.pop();
-                    }
-                    
-                    if (!recovered) {
-                        cerr << "Error recovery failed - could not find suitable state\n";
-                        return nullptr;
-                    }
-                    continue;  // Try parsing again with the current symbol
-                }
-                
-                // Skip erroneous input if not a sync symbol
-                cerr << "Skipping invalid input: " << symbol << '\n';
-                i++;
-                continue;
-            }
-
-            string action = actionIt->second.first;
-            int actionValue = actionIt->second.second;
-            
-            if (action == "POMAKNI") {
-                cerr << "POMAKNI " << actionValue << '\n';
-                
-                // Create new nodes for symbol and state
-                Node* symbolNode = new Node(symbol, inputLine);
-                Node* newStateNode = new Node(actionValue);
-                
-                // Push in correct order
-                nodeStack.emplace(symbolNode);
-                nodeStack.emplace(newStateNode);
-                i++;
-                
-            } else if (action == "REDUCIRAJ") {
-                cerr << "REDUCIRAJ " << actionValue << '\n';
-                
-                // Get production rule
-                auto production = table.ID_PRODUKCIJE_MAPA.at(actionValue);
-                cerr << "Reducing using production " << actionValue << ": " 
-                    << production.first << " -> ";
-                for (const auto& sym : production.second) {
-                    cerr << sym << " ";
-                }
-                cerr << '\n';
-                
-                // Create new node for the reduced non-terminal
-                Node* newNode = new Node(production.first);
-                if(production.second[0] != "$"){
-                    // Pop nodes for each symbol in the production's right-hand side
-                    for (size_t j = 0; j < production.second.size(); j++) {
-                        if (nodeStack.size() < 2) {
-                            cerr << "Error: Stack underflow during reduction\n";
-                            return nullptr;
-                        }
-                        
-                        nodeStack.pop();  // Pop state
-                        Node* child = nodeStack.top();  // Get symbol
-                        nodeStack.pop();  // Pop symbol
-                        
-                        // Add as child in correct order
-                        newNode->children.insert(newNode->children.begin(), child);
-                    }
-                }
-                else{
-                    Node* child = new Node("$", "$");
-                    newNode->children.push_back(child);
-                }
-                    
-                
-                
-                // Look up goto action
-                if (nodeStack.empty()) {
-                    cerr << "Error: Stack empty before goto\n";
-                    return nullptr;
-                }
-                
-                auto gotoIt = table.novoStanje.find({nodeStack.top()->state, newNode->symbol});
-                if (gotoIt == table.novoStanje.end()) {
-                    cerr << "Error: No goto action found for state " << nodeStack.top()->state 
-                        << " and symbol " << newNode->symbol << '\n';
-                    return nullptr;
-                }
-                
-                cerr << "Goto: State " << nodeStack.top()->state 
-                    << " with " << newNode->symbol 
-                    << " -> " << gotoIt->second.second << '\n';
-                
-                if (gotoIt->second.first == "STAVI") {
-                    nodeStack.emplace(newNode);
-                    nodeStack.emplace(new Node(gotoIt->second.second));
-                }
-                
-                rootNode = newNode;
-                
-            } else if (action == "PRIHVATI") {
-                cerr << "PRIHVATI" << '\n';
-                return rootNode;
-            } else {
-                cerr << "Error: Unknown action " << action << '\n';
-                return nullptr;
-            }
+    else root = previousFile.empty() ? analyzer.cinAndPrint() : reparse(analyzer, previousFile, input);
+    auto parsed = std::chrono::steady_clock::now();
+
+    if (treeFile.empty()) analyzer.printFromRoot(root);
+    else if (treeFile == "-") analyzer.writeBinaryTree(root, stdout);
+    else {
+        FILE* out = fopen(treeFile.c_str(), "wb");
+        if (!out) {
+            cerr << "Cannot open " << treeFile << '\n';
+            return 1;
         }
-
-        cerr << "Warning: Reached end of input without explicit accept\n";
-        return rootNode;
+        analyzer.writeBinaryTree(root, out);
+        fclose(out);
     }
 
-    void printFromRoot(Node* root, int depth = 0) {
-        if (!root) return;  // Add this check to prevent segmentation fault
-        
-        // Print indentation and symbol
-        if(root->isTerminal()){
-            std::cout << string(depth, ' ') << root->content;
-        }
-        else{
-            std::cout << string(depth, ' ') << root->symbol;
-        }
-        std::cout << '\n';
-        
-        // Recursively print all children
-        for (auto child : root->children) {
-            printFromRoot(child, depth + 1);
-        }
+    if (traceLevel != trace::OFF) analyzer.trace.dump(traceFile);
+
+    if (stats) {
+        auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        //u GLR načinu su brojači GLR parsera, osim ako se nakon neuspjeha parsiralo LR parserom (tada je glr false)
+        cerr << "{\"tokens\": " << (glr ? glrParser.tokens : analyzer.tokens)
+            << ", \"reductions\": " << (glr ? glrParser.reductions : analyzer.reductions)
+            << ", \"max_depth\": " << (glr ? glrParser.maxDepth : analyzer.maxDepth)
+            << ", \"errors\": " << analyzer.errors << ", \"reused\": " << analyzer.reused
+            << ", \"parse_ms\": " << ms(start, parsed) << ", \"output_ms\": " << ms(parsed, std::chrono::steady_clock::now())
+            << ", \"peak_rss_kb\": " << usage.ru_maxrss << "}\n";
     }
-};
-
-
-
-
-int main() {
-    ParsingTableStuff table("tablica.txt");
-    table.printLoaded();
-    std::cerr << "Parsing table constructed" << std::endl;
-
-    SyntaxAnalyzer analyzer(table);
-    cerr << "Analyzer constructed" << std::endl;
-    Node* root = analyzer.cinAndPrint();
-
-    analyzer.printFromRoot(root);
 
     return 0;
-}
\ No newline at end of file
+}
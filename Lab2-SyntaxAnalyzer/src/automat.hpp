@@ -2,6 +2,10 @@
 
 #include "utils.hpp"
 #include "grammar.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_set>
 
 class eNKA 
 {
@@ -31,9 +35,7 @@ public:
         symbols.emplace(S);
         
         //dodaje se jedina produkcija po pravilu a) iz skripte
-        generator.emplace(q0 = getState(
-            {S, grammar.PRODUKCIJE.at(S).at(0), {end_sym}}
-        ));
+        generator.emplace(q0 = getState(grammar.pocetnaStavka()));
         
         //za svaku stavku rekurzivno generiranu iz početne:
         while (!generator.empty()) 
@@ -46,31 +48,25 @@ public:
             generator.pop();
 
             //za svaku stavku dobivenu shiftanjem točke u desno:
-            while (!item.isComplete())
+            while (!grammar.isComplete(item))
             {
                 //dohvati sljedeći znak iza točke
-                const Symbol nextSym = item.symbolAfterDot();
+                const Symbol nextSym = grammar.symbolAfterDot(item);
                 symbols.emplace(nextSym);
 
-                //beta je niz znakova iza sljedeceg simbola kao u skripti str 148
-                const Word& beta = item.shift_dot_r().after_dot;
-                //T je lookahead kao u skripti
-                const set<Symbol> T = 
-                    make_union ( //računato po pravilima i) ii) --//--
-                        grammar.startsWith(beta), 
-                        (grammar.isVanishing(beta) ? item.lookahead : set<Symbol>{})
-                    );
+                //T je lookahead kao u skripti, iz niza znakova beta iza sljedeceg simbola (str 148)
+                //računato po pravilima i) ii) --//--
+                const Bitset T = grammar.closureLookahead(item);
+                item = item.shifted();
 
                 //dodajem produkcije po pravilu c) --//--
-                if (grammar.PRODUKCIJE.count(nextSym)) {
-                    for (const Word& production : grammar.PRODUKCIJE.at(nextSym)) 
-                    {
-                        State nextState = getState({nextSym, production, T});
-                        //dodaje se prijelaz
-                        transitions[state][eps].insert(nextState);
-                        //sljedece stanje se stavlja u queue za evaluaciju
-                        if (nextState == ID-1) generator.push(nextState);
-                    }
+                for (int production : grammar.PRODUKCIJE_OD[nextSym]) 
+                {
+                    State nextState = getState({production, 0, T});
+                    //dodaje se prijelaz
+                    transitions[state][eps].insert(nextState);
+                    //sljedece stanje se stavlja u queue za evaluaciju
+                    if (nextState == ID-1) generator.push(nextState);
                 }
               
                 //dodajem produkciju po pravilu b) --//--
@@ -162,12 +158,152 @@ public:
     const State start;
 
 // private:
-    StateMap<set<LR1Item>> items;
+    StateMap<ItemSet> items;
     StateMap<map<Symbol, State>> transitions;
 
 public:
     DKA() : start(ID) {}
 
+    /*
+        Izravna konstrukcija skupova stavki (zatvaranje i prijelazi), bez eNKA.
+        Stanje je određeno jezgrom (stavke s točkom iza barem jednog znaka, odnosno početna stavka),
+        a jezgre se traže po hashu pa se zatvaranje računa samo za nova stanja.
+        Redoslijed obrade i numeracija stanja su isti kao kod DKA(eNKA), pa je i tablica ista.
+    */
+    DKA(const Grammar& grammar) : start(ID)
+    {
+        std::unordered_map<std::size_t, vector<State>> fingerprints;
+        vector<ItemSet> kernels;
+        queue<State> state_queue;
+
+        //vraća postojeće stanje s tom jezgrom ili dodaje novo
+        auto getState = [&](ItemSet&& kernel) 
+        {
+            vector<State>& candidates = fingerprints[std::hash<ItemSet>()(kernel)];
+            for (State state : candidates)
+                if (kernels[state] == kernel) return state;
+
+            candidates.push_back(ID);
+            kernels.emplace_back(std::move(kernel));
+            state_queue.push(ID);
+            return ID++;
+        };
+
+        getState({grammar.pocetnaStavka()});
+
+        while (!state_queue.empty()) 
+        {
+            State id = state_queue.front();
+            state_queue.pop();
+
+            items[id] = closure(kernels[id], grammar);
+
+            for (auto& [sym, kernel] : gotoKernels(items[id], grammar))
+                transitions[id][sym] = getState(std::move(kernel));
+        }
+    }
+
+    /*
+        Paralelna inačica DKA(grammar). Dretve uzimaju neobrađena stanja iz zajedničkog reda i računaju
+        zatvaranje i prijelaze. Stanja se traže u hash mapi podijeljenoj na dijelove s vlastitim mutexom,
+        a dok traje gradnja stanja su samo čvorovi bez broja. Na kraju se numeriraju obilaskom u širinu
+        od početnog stanja po znakovima redom, isto kao u DKA(grammar), pa je tablica uvijek ista.
+    */
+    DKA(const Grammar& grammar, unsigned jobs) : start(ID)
+    {
+        struct Node {
+            ItemSet kernel;
+            ItemSet items;
+            map<Symbol, Node*> next;
+        };
+
+        struct Shard {
+            std::mutex lock;
+            std::unordered_map<std::size_t, vector<std::unique_ptr<Node>>> nodes;
+        };
+
+        static const std::size_t SHARDS = 64;
+        vector<Shard> shards(SHARDS);
+
+        std::mutex queue_lock;
+        std::condition_variable ready;
+        vector<Node*> pending;
+        int active = 0; //stanja koja su stvorena, a još nisu obrađena
+
+        auto getNode = [&](ItemSet&& kernel) 
+        {
+            std::size_t hash = std::hash<ItemSet>()(kernel);
+            Shard& shard = shards[hash % SHARDS];
+            Node* node;
+            {
+                std::lock_guard<std::mutex> guard(shard.lock);
+                vector<std::unique_ptr<Node>>& candidates = shard.nodes[hash];
+                for (const auto& candidate : candidates)
+                    if (candidate->kernel == kernel) return candidate.get();
+
+                candidates.push_back(std::make_unique<Node>());
+                node = candidates.back().get();
+                node->kernel = std::move(kernel);
+            }
+            {
+                std::lock_guard<std::mutex> guard(queue_lock);
+                pending.push_back(node);
+                active++;
+            }
+            ready.notify_one();
+            return node;
+        };
+
+        auto worker = [&]() 
+        {
+            while (true) 
+            {
+                Node* node;
+                {
+                    std::unique_lock<std::mutex> guard(queue_lock);
+                    ready.wait(guard, [&] { return !pending.empty() || active == 0; });
+                    if (pending.empty()) return;
+                    node = pending.back();
+                    pending.pop_back();
+                }
+
+                node->items = closure(node->kernel, grammar);
+                for (auto& [sym, kernel] : gotoKernels(node->items, grammar))
+                    node->next[sym] = getNode(std::move(kernel));
+
+                std::lock_guard<std::mutex> guard(queue_lock);
+                if (--active == 0) ready.notify_all();
+            }
+        };
+
+        Node* root = getNode({grammar.pocetnaStavka()});
+
+        vector<std::thread> workers;
+        for (unsigned i = 0; i < std::max(jobs, 1u); i++) workers.emplace_back(worker);
+        for (std::thread& thread : workers) thread.join();
+
+        //deterministička numeracija
+        std::unordered_map<Node*, State> ids = {{root, ID++}};
+        queue<Node*> order;
+        order.push(root);
+        while (!order.empty()) 
+        {
+            Node* node = order.front();
+            order.pop();
+            State id = ids.at(node);
+            items[id] = std::move(node->items);
+
+            for (const auto& [sym, next] : node->next) {
+                auto [it, inserted] = ids.emplace(next, ID);
+                if (inserted) {
+                    ID++;
+                    order.push(next);
+                }
+                transitions[id][sym] = it->second;
+            }
+        }
+    }
+
     DKA(const eNKA& enka) : start(ID)
     {
         SetMap<State> mapper;
@@ -188,7 +324,9 @@ public:
 
             //dohvati sve LR1Iteme
             for (State state : current)
-                items[id].insert(enka.items.at(state));
+                items[id].push_back(enka.items.at(state));
+            std::sort(items[id].begin(), items[id].end());
+            items[id].erase(std::unique(items[id].begin(), items[id].end()), items[id].end());
             
             //pronađi sve prijelaze
             for (const Symbol& sym : enka.symbols) 
@@ -210,7 +348,219 @@ public:
         }
     }
 
-    inline const set<LR1Item>& itemsAtState(State state) const {
+    /*
+        LALR(1): stanja s istom LR(0) jezgrom (stavke bez lookaheada) se spajaju u jedno,
+        a lookaheadi istih stavki se ujedinjuju. Stanja se prenumeriraju redom prvog pojavljivanja
+        jezgre pa početno stanje ostaje 0. Vraća broj novih reduciraj/reduciraj konflikata,
+        tj. onih koji nisu postojali ni u jednom od spojenih stanja (ispisuju se na cerr).
+    */
+    int spojiJezgre(const Grammar& grammar)
+    {
+        map<ItemSet, State> jezgre;
+        vector<State> novi(ID);
+        State newID = 0;
+
+        for (State state = 0; state < ID; state++) {
+            ItemSet jezgra;
+            for (const LR1Item& item : items.at(state))
+                jezgra.push_back(item.core());
+            jezgra.erase(std::unique(jezgra.begin(), jezgra.end()), jezgra.end());
+            auto [it, inserted] = jezgre.emplace(std::move(jezgra), newID);
+            if (inserted) newID++;
+            novi[state] = it->second;
+        }
+
+        //reducirajuce produkcije po lookaheadu, za svako staro i svako novo stanje
+        using Redukcije = map<Symbol, set<int>>;
+        vector<Redukcije> stare(ID), spojene(newID);
+        vector<map<LR1Item, Bitset>> lookaheadi(newID);
+
+        for (State state = 0; state < ID; state++)
+            for (const LR1Item& item : items.at(state)) 
+            {
+                //početna produkcija se ne reducira nego prihvaća
+                if (grammar.isComplete(item) && grammar.left(item) != grammar.BEGIN_SYMBOL) {
+                    int id = item.production;
+                    item.lookahead.forEach([&](Symbol sym) {
+                        stare[state][sym].insert(id);
+                        spojene[novi[state]][sym].insert(id);
+                    });
+                }
+
+                lookaheadi[novi[state]][item.core()] |= item.lookahead;
+            }
+
+        int konflikti = 0;
+        for (State state = 0; state < newID; state++)
+            for (const auto& [sym, ids] : spojene[state]) 
+            {
+                if (ids.size() < 2) continue;
+
+                bool postojao = false;
+                for (State old = 0; old < ID; old++)
+                    if (novi[old] == state && exists(stare[old], sym) && stare[old].at(sym).size() > 1)
+                        postojao = true;
+                if (postojao) continue;
+
+                konflikti++;
+                cerr << "LALR: novi reduciraj/reduciraj konflikt u stanju " << state << " za znak " << grammar.name(sym) << ", produkcije:";
+                for (int id : ids) cerr << " " << id;
+                cerr << endl;
+            }
+
+        StateMap<ItemSet> newItems;
+        StateMap<map<Symbol, State>> newTransitions;
+
+        for (State state = 0; state < newID; state++)
+            for (auto& [item, lookahead] : lookaheadi[state])
+                newItems[state].emplace_back(item.production, item.dot, std::move(lookahead));
+
+        //stanja s istom jezgrom imaju prijelaze u stanja s istom jezgrom
+        for (const auto& [state, trans] : transitions)
+            for (const auto& [sym, next] : trans)
+                newTransitions[novi[state]][sym] = novi[next];
+
+        items = std::move(newItems);
+        transitions = std::move(newTransitions);
+        ID = newID;
+
+        return konflikti;
+    }
+
+    /*
+        Minimalni LR(1) po Pageru (slaba kompatibilnost).
+        Svaka jezgra ima po jednu stavku sa skupom lookaheada. Kad prijelaz da jezgru koja već postoji,
+        stanja se spajaju ako su slabo kompatibilna (tada spajanje sigurno ne uvodi nove konflikte),
+        inače nastaje novo stanje kao u kanonskom LR(1). Ako spajanje proširi lookaheade postojećeg
+        stanja, ono se ponovno obrađuje i proširenje se širi na njegove sljedbenike.
+    */
+    static DKA pager(const Grammar& grammar)
+    {
+        DKA dka;
+        map<ItemSet, vector<State>> jezgre;
+        vector<ItemSet> kernels; //jedna stavka po jezgri, poredano po jezgri
+        queue<State> worklist;
+        vector<bool> queued;
+
+        auto spoji = [&](State state, const ItemSet& kernel) 
+        {
+            bool changed = false;
+            for (std::size_t i = 0; i < kernel.size(); i++)
+                changed |= (kernels[state][i].lookahead |= kernel[i].lookahead);
+            if (changed && !queued[state]) {
+                queued[state] = true;
+                worklist.push(state);
+            }
+        };
+
+        auto getState = [&](map<LR1Item, Bitset>&& next) 
+        {
+            ItemSet jezgra, kernel;
+            for (auto& [core, lookahead] : next) {
+                jezgra.push_back(core);
+                kernel.emplace_back(core.production, core.dot, std::move(lookahead));
+            }
+
+            vector<State>& candidates = jezgre[jezgra];
+            for (State state : candidates)
+                if (slaboKompatibilni(kernels[state], kernel)) {
+                    spoji(state, kernel);
+                    return state;
+                }
+
+            candidates.push_back(dka.ID);
+            kernels.emplace_back(std::move(kernel));
+            queued.push_back(true);
+            worklist.push(dka.ID);
+            return dka.ID++;
+        };
+
+        LR1Item pocetna = grammar.pocetnaStavka();
+        getState({{pocetna.core(), pocetna.lookahead}});
+
+        while (!worklist.empty()) 
+        {
+            State id = worklist.front();
+            worklist.pop();
+            queued[id] = false;
+
+            map<Symbol, map<LR1Item, Bitset>> next;
+            for (const LR1Item& item : closure(kernels[id], grammar))
+                if (!grammar.isComplete(item))
+                    next[grammar.symbolAfterDot(item)][item.core().shifted()] |= item.lookahead;
+
+            for (auto& [sym, kernel] : next) 
+            {
+                //već obrađeno stanje, proširenje lookaheada ide izravno u postojeći prijelaz
+                if (dka.exists_trans(id, sym)) {
+                    ItemSet ordered;
+                    for (auto& [core, lookahead] : kernel)
+                        ordered.emplace_back(core.production, core.dot, std::move(lookahead));
+                    spoji(dka.transitions.at(id).at(sym), ordered);
+                }
+                else dka.transitions[id][sym] = getState(std::move(kernel));
+            }
+        }
+
+        for (State state = 0; state < dka.ID; state++)
+            dka.items[state] = closure(kernels[state], grammar);
+
+        return dka;
+    }
+
+    //uvjet slabe kompatibilnosti iz Pagerovog rada, jezgre obaju stanja su iste i istim redom
+    static bool slaboKompatibilni(const ItemSet& a, const ItemSet& b)
+    {
+        for (std::size_t i = 0; i < a.size(); i++)
+            for (std::size_t j = i + 1; j < a.size(); j++) 
+            {
+                const Bitset &ai = a[i].lookahead, &aj = a[j].lookahead;
+                const Bitset &bi = b[i].lookahead, &bj = b[j].lookahead;
+
+                if (!ai.intersects(bj) && !bi.intersects(aj)) continue;
+                if (ai.intersects(aj) || bi.intersects(bj)) continue;
+                return false;
+            }
+        return true;
+    }
+
+    //jezgre sljedećih stanja po znaku iza točke, map da se znakovi obrađuju istim redom kao enka.symbols
+    //pomak točke ne mijenja poredak stavki pa su jezgre već sortirane
+    static map<Symbol, ItemSet> gotoKernels(const ItemSet& current, const Grammar& grammar)
+    {
+        map<Symbol, ItemSet> next;
+        for (const LR1Item& item : current)
+            if (!grammar.isComplete(item))
+                next[grammar.symbolAfterDot(item)].push_back(item.shifted());
+        return next;
+    }
+
+    //zatvaranje skupa stavki, lookaheadi se računaju kao u eNKA (pravila i) ii) iz skripte)
+    static ItemSet closure(const ItemSet& kernel, const Grammar& grammar)
+    {
+        ItemSet result = kernel;
+        std::unordered_set<LR1Item> seen(kernel.begin(), kernel.end());
+
+        //result je ujedno i red stavki za obradu
+        for (std::size_t i = 0; i < result.size(); i++) 
+        {
+            if (grammar.isComplete(result[i])) continue;
+
+            const Symbol nextSym = grammar.symbolAfterDot(result[i]);
+            if (grammar.PRODUKCIJE_OD[nextSym].empty()) continue;
+
+            const Bitset T = grammar.closureLookahead(result[i]);
+            for (int production : grammar.PRODUKCIJE_OD[nextSym]) {
+                LR1Item item(production, 0, T);
+                if (seen.insert(item).second) result.push_back(std::move(item));
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    inline const ItemSet& itemsAtState(State state) const {
         return items.at(state);
     } 
 
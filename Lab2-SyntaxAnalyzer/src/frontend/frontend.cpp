@@ -0,0 +1,102 @@
+#include "../../../Lab1-LexicalAnalyzer/src/analizator/Analyzer.hpp"
+#include "../analizator/SyntaxAnalyzer.hpp"
+#include "spsc_ring.hpp"
+
+#include <thread>
+
+/* kako koristiti:
+    Spojeni leksički i sintaksni analizator. Leksički analizator radi na svojoj dretvi i šalje
+    jedinke kroz SpscRing, a LR parser ih paralelno troši na glavnoj dretvi, tako da se
+    leksička i sintaksna analiza preklapaju i nitko ne drži cijeli niz jedinki u memoriji.
+
+    g++ frontend.cpp ../../../Lab1-LexicalAnalyzer/src/analizator/automata.cpp -std=c++17 -O2 -pthread -o frontend
+    ./frontend [table.txt] [tablica.txt] [--tree-bin stablo.bin] < program.c
+
+    table.txt je izlaz generatora iz Lab1, tablica.txt (ili tablica.bin) izlaz generatora iz Lab2.
+    S --tree-bin se stablo zapiše binarno (analizator/TreeFormat.hpp) i može ići ravno u Lab3.
+*/
+
+//kompaktni zapis jedinke, leksem je pozicija u ulaznom bufferu koji živi do kraja programa
+struct TokenRecord {
+    uint32_t rule;
+    int32_t line;
+    uint32_t offset;
+    uint32_t length;
+};
+
+static constexpr std::size_t RING_SIZE = 1024;
+
+int main(int argc, char** argv)
+{
+    std::string treeFile = "";
+    vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tree-bin" && i + 1 < argc) treeFile = argv[++i];
+        else positional.push_back(arg);
+    }
+    std::string lexTable = positional.size() > 0 ? positional[0] : "table.txt";
+    std::string parseTable = positional.size() > 1 ? positional[1] : "tablica.txt";
+
+    lex::init(lexTable);
+    LRTable table(parseTable);
+
+    //imena i id-evi završnih znakova se računaju unaprijed da parser ne dira AUTOMATA dok ga leksički analizator koristi
+    vector<string> names;
+    vector<int32_t> terminals;
+    for (const auto& [id, nka] : lex::AUTOMATA) {
+        if (names.size() <= id) names.resize(id + 1), terminals.resize(id + 1, -1);
+        names[id] = nka.name;
+        terminals[id] = table.terminal(nka.name);
+    }
+
+    std::string input = "", line;
+    while (std::getline(std::cin, line)) input += line + "\n";
+
+    SpscRing<TokenRecord, RING_SIZE> ring;
+
+    std::thread lexer([&input, &ring]() {
+        lex::Analyzer analyzer(input);
+        lex::Token token;
+        while (analyzer.next_token(token))
+            if (!ring.push({
+                token.rule, token.line,
+                (uint32_t) (token.lexeme.data() - input.data()), (uint32_t) token.lexeme.size()
+            })) break;
+        ring.close();
+    });
+
+    SyntaxAnalyzer analyzer(table);
+    std::string current; //redak trenutne jedinke, token.line pokazuje u njega do sljedeće jedinke
+    Node* root = analyzer.parse([&](InputToken& token) {
+        TokenRecord record;
+        if (!ring.pop(record)) return false;
+        current = names[record.rule];
+        current += ' ';
+        current += std::to_string(record.line);
+        current += ' ';
+        current.append(input, record.offset, record.length);
+        token.symbol = names[record.rule];
+        token.terminal = terminals[record.rule];
+        token.line = current;
+        return true;
+    });
+
+    //parser može stati prije kraja ulaza (neuspjeli oporavak), pa leksički analizator ne smije čekati na pun red
+    ring.cancel();
+    lexer.join();
+
+    if (treeFile.empty()) analyzer.printFromRoot(root);
+    else if (treeFile == "-") analyzer.writeBinaryTree(root, stdout);
+    else {
+        FILE* out = fopen(treeFile.c_str(), "wb");
+        if (!out) {
+            cerr << "Cannot open " << treeFile << '\n';
+            return 1;
+        }
+        analyzer.writeBinaryTree(root, out);
+        fclose(out);
+    }
+
+    return 0;
+}
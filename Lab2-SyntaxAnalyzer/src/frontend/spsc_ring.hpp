@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+/*
+    Ograničeni lock-free red za točno jednog proizvođača i jednog potrošača.
+    push() zove samo proizvođač, a pop() samo potrošač. Kada proizvođač završi zove close(),
+    nakon čega pop() vraća false čim isprazni red. Ako potrošač stane prije kraja (npr. parser odustane),
+    zove cancel(), pa push() više ne čeka slobodno mjesto nego vraća false i proizvođač treba prestati.
+    Kapacitet mora biti potencija broja 2 da bi se indeks računao maskom.
+*/
+template<typename T, std::size_t N>
+class SpscRing
+{
+    static_assert(N && (N & (N - 1)) == 0, "kapacitet mora biti potencija broja 2");
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    //svaka strana piše samo svoj indeks, a tuđi čita rijetko (lokalna kopija)
+    alignas(CACHE_LINE) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail = 0;
+
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead = 0;
+
+    alignas(CACHE_LINE) std::atomic<bool> closed{false};
+    std::atomic<bool> cancelled{false};
+
+    alignas(CACHE_LINE) T buffer[N];
+
+public:
+    //false ako je potrošač odustao (cancel), jedinka se tada odbacuje
+    bool push(const T& item)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        while (t - cachedHead == N) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead != N) break;
+            if (cancelled.load(std::memory_order_acquire)) return false;
+            std::this_thread::yield();
+        }
+        buffer[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        while (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h != cachedTail) break;
+            if (closed.load(std::memory_order_acquire)) {
+                //close() je mogao doći između dva čitanja, zato se tail čita još jednom
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (h == cachedTail) return false;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        item = buffer[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    void cancel() {
+        cancelled.store(true, std::memory_order_release);
+    }
+};
@@ -0,0 +1,377 @@
+#include <iostream>
+#include <fstream>
+#include "utils.hpp"
+#include "automat.hpp"
+#include "grammar.hpp"
+#include "analizator/LRFormat.hpp"
+#include "profiler.hpp"
+
+struct Action
+{
+    std::string name;
+    int id;
+
+    Action() : name("ODBACI"), id(0) {}
+
+    Action(std::string name, int id) : name(name), id(id) {}
+
+    Action(std::string str)
+    {
+        *this = std::move(str);
+    }
+
+    Action &operator=(std::string str)
+    {
+        name = consumeNextWord(str);
+        id = to_int(consumeNextWord(str));
+        return *this;
+    }
+
+    std::string toString() const
+    {
+        return name + " " + std::to_string(id);
+    }
+};
+
+struct ParsingTable
+{
+    map<pair<State, Symbol>, Action> akcija;     // (state, terminal) -> action
+    map<pair<State, Symbol>, Action> novoStanje; // (state, non-terminal) -> next state
+    set<pair<pair<State, Symbol>, int>> konflikti; // akcije koje su izgubile pri razrjesavanju (za GLR), kodirane kao u LRFormat
+
+    ParsingTable() {}
+
+    ParsingTable(const DKA &dka, const Grammar &grammar)
+    {
+        for (State current = 0; current < (int)dka.size(); current++)
+        {
+            // za svaku stavku u stanju:
+            for (const LR1Item &item : dka.items.at(current))
+            {
+                const Symbol sym = grammar.symbolAfterDot(item);
+                const auto key = pair{current, sym};
+
+                // provjerava vrijedi li pravilo c) iz udzb str 151
+                if (grammar.left(item) == grammar.BEGIN_SYMBOL && sym == end_sym)
+                {
+                    akcija.emplace(key, Action{"PRIHVATI"});
+                    continue;
+                }
+                // provjera vrijedi li pravilo a) --//-- ... uz dodatni uvjet prednosti iz uputa labosa
+                if (dka.exists_trans(current, sym))
+                {
+                    State nextState = dka.transitions.at(current).at(sym);
+
+                    if (grammar.isTerminating(sym))
+                    {
+                        if (exists(akcija, key) && akcija.at(key).name == "REDUCIRAJ")
+                            konflikti.emplace(key, lr::encode(lr::REDUCIRAJ, akcija.at(key).id));
+                        akcija[key] = Action{"POMAKNI", nextState};
+                    }
+                    else
+                        novoStanje.emplace(key, Action{"STAVI", nextState});
+                }
+                // provjerava vrijedi li pravilo b) --//--
+                if (grammar.isComplete(item))
+                {
+                    // id produkcije
+                    int id = item.production;
+
+                    item.lookahead.forEach([&](Symbol lookahead)
+                    {
+                        const auto key = pair{current, lookahead};
+
+                        // razrjesavanje nejednoznacnosti, gubitnik se pamti u konflikti
+                        if (exists(akcija, key) && akcija.at(key).name != "POMAKNI" && akcija.at(key).id > id)
+                        {
+                            if (akcija.at(key).name == "REDUCIRAJ")
+                                konflikti.emplace(key, lr::encode(lr::REDUCIRAJ, akcija.at(key).id));
+                            akcija[key] = Action{"REDUCIRAJ", id};
+                        }
+                        else if (!exists(akcija, key))
+                            akcija.emplace(key, Action{"REDUCIRAJ", id});
+                        else if (akcija.at(key).name != "PRIHVATI" && !(akcija.at(key).name == "REDUCIRAJ" && akcija.at(key).id == id))
+                            konflikti.emplace(key, lr::encode(lr::REDUCIRAJ, id));
+                    });
+                }
+            }
+        }
+    };
+
+    void outputToFile(const std::string &filename, const Grammar &grammar) const
+    {
+        std::ofstream out(filename);
+
+        out << "SYNC_SYMBOLS:" << endl;
+        for (const Symbol &symbol : grammar.SYNC_ZAVRSNI)
+            out << grammar.name(symbol) << endl;
+
+        out << "\nGRAMMAR_PRODUCTIONS:" << endl;
+        for (const auto &[production, id] : grammar.ID_PRODUKCIJE)
+            out << id << " " << grammar.name(production.first) << " -> " << grammar.toString(production.second) << endl; // REVERSE
+
+        out << "\nAKCIJA:" << endl;
+        for (const auto &[key, action] : akcija)
+            out << key.first << " " << grammar.name(key.second) << " " << action.toString() << endl;
+
+        out << "\nNOVO STANJE:" << endl;
+        for (const auto &[key, action] : novoStanje)
+            out << key.first << " " << grammar.name(key.second) << " " << action.toString() << endl;
+
+        out.close();
+    }
+
+    /*
+        Binarna tablica za mmap (format je opisan u analizator/LRFormat.hpp).
+        Ako je defaultReductions, najčešća redukcija svakog stanja postaje njegova default akcija i ne zapisuje se
+        u comb. Tablica je tada manja, ali parser na pogrešnom znaku prvo reducira pa tek onda javi grešku,
+        pa se oporavak od pogreške može razlikovati od tekstualne tablice.
+        Ako je conflicts, na kraj se zapišu i akcije iz konflikti, za GLR analizator (./analizator tablica.bin --glr).
+    */
+    void outputToBinary(const std::string &filename, const Grammar &grammar, bool defaultReductions, bool conflicts = false) const
+    {
+        const int32_t terminals = grammar.FIRST_NEZAVRSNI;
+        const int32_t symbols = grammar.size();
+        const int32_t productions = grammar.ID_global;
+
+        int32_t states = 0;
+        for (const auto &[key, action] : akcija) states = std::max(states, key.first + 1);
+        for (const auto &[key, action] : novoStanje) states = std::max(states, key.first + 1);
+
+        vector<int32_t> defaults(states, lr::ODBACI);
+        if (defaultReductions)
+        {
+            vector<map<int, int>> counts(states);
+            for (const auto &[key, action] : akcija)
+                if (action.name == "REDUCIRAJ") counts[key.first][action.id]++;
+            for (State state = 0; state < states; state++)
+            {
+                int best = -1, count = 0;
+                for (const auto &[id, n] : counts[state])
+                    if (n > count) best = id, count = n;
+                if (best >= 0) defaults[state] = lr::encode(lr::REDUCIRAJ, best);
+            }
+        }
+
+        vector<vector<pair<int32_t, int32_t>>> actionRows(states), gotoRows(states);
+        for (const auto &[key, action] : akcija)
+        {
+            lr::ActionKind kind = action.name == "POMAKNI" ? lr::POMAKNI 
+                                : action.name == "REDUCIRAJ" ? lr::REDUCIRAJ : lr::PRIHVATI;
+            int32_t encoded = lr::encode(kind, kind == lr::PRIHVATI ? 0 : action.id);
+            if (encoded != defaults[key.first])
+                actionRows[key.first].emplace_back(key.second, encoded);
+        }
+        for (const auto &[key, action] : novoStanje)
+            gotoRows[key.first].emplace_back(key.second - terminals, action.id);
+
+        lr::Comb actions = lr::pack(actionRows, lr::ODBACI), gotos = lr::pack(gotoRows, -1);
+
+        vector<int32_t> namesBegin = {0};
+        std::string names;
+        for (Symbol sym = 0; sym < symbols; sym++)
+        {
+            names += grammar.name(sym);
+            namesBegin.push_back(names.size());
+        }
+        names.resize((names.size() + 3) / 4 * 4, '\0');
+
+        vector<int32_t> left(productions), begin = {0}, rhs;
+        for (int id = 0; id < productions; id++)
+        {
+            const auto &[sym, word] = grammar.PRODUKCIJA[id];
+            left[id] = sym;
+            for (int i = (int)word.size() - 1; i >= 0; i--) // REVERSE
+                rhs.push_back(word[i]);
+            begin.push_back(rhs.size());
+        }
+
+        vector<int32_t> sync(grammar.SYNC_ZAVRSNI.begin(), grammar.SYNC_ZAVRSNI.end());
+
+        // sync je sortiran (dolazi iz seta), pa se indeks znaka nađe binarnim pretraživanjem
+        const uint32_t recoverWords = lr::recoverWords(sync.size());
+        vector<int32_t> recover((std::size_t)states * recoverWords, 0);
+        for (const auto &[key, action] : akcija)
+        {
+            auto it = std::lower_bound(sync.begin(), sync.end(), key.second);
+            if (it == sync.end() || *it != key.second) continue;
+            uint32_t index = it - sync.begin();
+            recover[(std::size_t)key.first * recoverWords + index / 32] |= int32_t(uint32_t(1) << (index % 32));
+        }
+
+        lr::Header header = {
+            {lr::MAGIC[0], lr::MAGIC[1], lr::MAGIC[2], lr::MAGIC[3]}, lr::VERSION,
+            (uint32_t)states, (uint32_t)terminals, (uint32_t)symbols, (uint32_t)productions, (uint32_t)sync.size(),
+            (uint32_t)actions.next.size(), (uint32_t)gotos.next.size(), (uint32_t)rhs.size(), (uint32_t)namesBegin.back(),
+            (defaultReductions ? lr::DEFAULT_REDUCTIONS : 0) | (conflicts ? lr::CONFLICTS : 0)
+        };
+
+        std::ofstream out(filename, std::ios::binary);
+        auto write = [&out](const vector<int32_t> &array)
+        {
+            out.write((const char *)array.data(), array.size() * sizeof(int32_t));
+        };
+
+        out.write((const char *)&header, sizeof(header));
+        write(namesBegin);
+        out.write(names.data(), names.size());
+        write(left), write(begin), write(rhs);
+        write(sync);
+        write(recover);
+        write(defaults);
+        write(actions.base), write(actions.next), write(actions.check);
+        write(gotos.base), write(gotos.next), write(gotos.check);
+        if (conflicts)
+        {
+            vector<int32_t> triples = {(int32_t)konflikti.size()};
+            for (const auto &[key, action] : konflikti)
+                triples.insert(triples.end(), {key.first, key.second, action});
+            write(triples);
+        }
+        out.close();
+    }
+};
+
+std::string input = "cin";
+
+// zamjena globalnog alokatora da profiler (--profile) može brojati alokacije, mora biti u točno jednoj datoteci programa
+static void* allocate (std::size_t size)
+{
+    profiler::count(size);
+    if (size == 0) size = 1;
+    while (true) {
+        if (void* p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new (std::size_t size) { return allocate(size); }
+void* operator new[] (std::size_t size) { return allocate(size); }
+void operator delete (void* p) noexcept { std::free(p); }
+void operator delete[] (void* p) noexcept { std::free(p); }
+void operator delete (void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[] (void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char **argv)
+{
+    // input = "../test/08pomred/test.san";
+    /* zastavice:
+        --lalr      spaja stanja DKA s istom LR(0) jezgrom (LALR(1) tablica), novi konflikti se ispisuju na cerr
+        --enka      DKA se gradi preko eNKA (stari put), inače izravno iz gramatike
+        --pager     minimalni LR(1): stanja s istom jezgrom se spajaju samo kad je to sigurno (Pager)
+        --jobs N    kanonski DKA se gradi s N dretvi (0 = broj jezgri, najviše broj jezgri), tablica je ista kao s jednom;
+                    samo za izravnu izgradnju, s --enka i --pager se DKA gradi na jednoj dretvi (ispiše se upozorenje)
+        --bin       dodatno zapisuje analizator/tablica.bin (comb zapis za mmap), analizator: ./analizator tablica.bin
+        --default-reduce  u tablica.bin najčešća redukcija stanja postaje default akcija (manja tablica)
+        --glr       kao --bin, a u tablica.bin se zadržavaju i akcije koje su izgubile u konfliktima (za GLR analizator)
+        --stats     na kraju na cerr ispisuje JSON redak s trajanjem svake faze u ms i brojem stanja (za benchmark.py)
+        --profile trace.json  za svaku fazu trajanje, alokacije, RSS i broj objekata u Chrome trace formatu (profiler.hpp)
+    */
+    bool lalr = false, enka_path = false, pager = false, binary = false, defaultReductions = false, glr = false, stats = false;
+    std::string profileFile;
+    unsigned jobs = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--lalr") lalr = true;
+        else if (arg == "--enka") enka_path = true;
+        else if (arg == "--pager") pager = true;
+        else if (arg == "--bin") binary = true;
+        else if (arg == "--default-reduce") defaultReductions = true;
+        else if (arg == "--glr") glr = binary = true;
+        else if (arg == "--stats") stats = true;
+        else if (arg == "--profile" && i + 1 < argc) profileFile = argv[++i];
+        else if (arg == "--jobs" && i + 1 < argc)
+        {
+            //samo znamenke, a više dretvi od jezgri ne pomaže pa se ograniči na njihov broj
+            std::string value = argv[++i];
+            unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+            if (value.empty() || value.size() > 9 || !std::all_of(value.begin(), value.end(), ::isdigit))
+            {
+                cerr << "--jobs treba nenegativan cijeli broj, a dobio je \"" << value << "\"" << endl;
+                return 1;
+            }
+            jobs = to_int(value);
+            if (jobs == 0 || jobs > cores) jobs = cores;
+        }
+    }
+
+    if (jobs > 1 && (enka_path || pager))
+    {
+        cerr << "Upozorenje: --jobs vrijedi samo za izravnu izgradnju DKA, uz " << (enka_path ? "--enka" : "--pager")
+             << " se gradi na jednoj dretvi" << endl;
+        jobs = 1;
+    }
+
+    profiler::enabled = !profileFile.empty();
+    profiler::Profiler profil;
+
+    auto brojDKA = [](const DKA& dka) -> vector<pair<std::string, uint64_t>> {
+        uint64_t prijelazi = 0, stavke = 0;
+        for (const auto& [state, trans] : dka.transitions) prijelazi += trans.size();
+        for (const auto& [state, items] : dka.items) stavke += items.size();
+        return {{"dka_states", dka.size()}, {"dka_transitions", prijelazi}, {"items", stavke}};
+    };
+
+    // korak 1 - parsiranje gramatike
+    Grammar grammar(input);
+    profil.end("gramatika", {{"symbols", grammar.size()}, {"productions", grammar.PRODUKCIJA.size()}});
+
+    // korak 2 - dodajemo novi pocetni znak (zasto ovo nije u konstruktoru?)
+    grammar.dodajNoviPocetniZnak(GRAMMAR_NEW_BEGIN_STATE);
+    profil.end("pocetni_znak");
+
+    // korak 3 i 4 - konstrukcija DKA, preko eNKA ili izravno zatvaranjem skupova stavki
+    DKA dka = [&]() {
+        if (!enka_path)
+            return pager     ? DKA::pager(grammar)
+                 : jobs > 1  ? DKA(grammar, jobs)
+                             : DKA(grammar);
+
+        // eNKA je zasebna faza da se vidi koliko košta stari put
+        eNKA enka(grammar);
+        uint64_t prijelazi = 0;
+        for (const auto& [state, trans] : enka.transitions)
+            for (const auto& [sym, next] : trans) prijelazi += next.size();
+        profil.end("enka", {{"enka_states", enka.size()}, {"enka_transitions", prijelazi}});
+        return DKA(enka);
+    }();
+    if (pager)
+        cerr << "Pager: " << dka.size() << " stanja" << endl;
+    profil.end("dka", brojDKA(dka));
+
+    // korak 4b - (opcionalno) spajanje stanja s istom jezgrom
+    if (lalr)
+    {
+        std::size_t canonical = dka.size();
+        int konflikti = dka.spojiJezgre(grammar);
+        cerr << "LALR: " << canonical << " -> " << dka.size() << " stanja, novih R/R konflikata: " << konflikti << endl;
+        profil.end("lalr", brojDKA(dka));
+    }
+
+    // korak 5 - konstrukcija tablice parsiranja
+    ParsingTable table(dka, grammar);
+    profil.end("tablica", {{"actions", table.akcija.size()}, {"gotos", table.novoStanje.size()}, {"conflicts", table.konflikti.size()}});
+
+    // korak 6 - ispis tablice parsiranja
+    table.outputToFile("analizator/tablica.txt", grammar);
+    if (binary)
+        table.outputToBinary("analizator/tablica.bin", grammar, defaultReductions, glr);
+    if (glr)
+        cerr << "GLR: " << table.konflikti.size() << " akcija u konfliktima" << endl;
+    profil.end("zapis");
+
+    if (stats)
+    {
+        cerr << "{\"states\": " << dka.size() << ", \"phases_ms\": {";
+        for (std::size_t i = 0; i < profil.phases.size(); i++)
+            cerr << (i ? ", " : "") << '"' << profil.phases[i].name << "\": " << profil.phases[i].duration_us / 1000;
+        cerr << "}}" << endl;
+    }
+    if (!profileFile.empty() && !profil.writeChromeTrace(profileFile))
+        cerr << "Ne mogu zapisati " << profileFile << endl;
+
+    return 0;
+}
\ No newline at end of file
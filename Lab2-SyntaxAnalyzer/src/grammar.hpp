@@ -3,14 +3,71 @@
 #include "utils.hpp"
 #include <fstream>
 
+/*
+    LR(1) stavka: produkcija (indeks u Grammar::PRODUKCIJA), položaj točke i skup lookaheada.
+    Znakovi produkcije se čitaju iz gramatike (Grammar::symbolAfterDot i ostali), tako da je
+    stavka mala, a usporedba i hash skoro besplatni. Skup stavki je sortirani vector (ItemSet).
+*/
+struct LR1Item 
+{
+    int production = 0;
+    int dot = 0;
+    Bitset lookahead;
+
+    LR1Item () {}
+
+    LR1Item (int production, int dot, Bitset lookahead = {})
+        : production(production), dot(dot), lookahead(std::move(lookahead)) 
+    {}
+
+    bool operator==(const LR1Item& other) const {
+        return production == other.production && dot == other.dot && lookahead == other.lookahead;
+    }
+
+    bool operator<(const LR1Item& other) const {
+        if (production != other.production) return production < other.production;
+        if (dot != other.dot) return dot < other.dot;
+        return lookahead < other.lookahead;
+    }
+
+    //stavka s točkom pomaknutom za jedan znak udesno
+    inline LR1Item shifted() const {
+        return {production, dot + 1, lookahead};
+    }
+
+    //ista stavka bez lookaheada (LR(0) jezgra)
+    inline LR1Item core() const {
+        return {production, dot};
+    }
+};
+
+template <>
+struct std::hash<LR1Item>
+{
+    std::size_t operator()(const LR1Item& k) const {
+        return ((std::size_t) k.production * 0x9e3779b1u + k.dot) ^ (k.lookahead.hash() << 1);
+    }
+};
+
+using ItemSet = vector<LR1Item>; //sortirano, bez duplikata
+
+/*
+    Znakovi se pri čitanju interniraju u int-ove: 0 je "$" (eps i kraj niza), zatim dolaze
+    završni znakovi redom kako su navedeni u %T, pa nezavršni. Tako se svi kontejneri generatora
+    ključaju malim brojevima, a imena trebaju samo za ispis tablice.
+*/
 class Grammar
 {
     std::ifstream in;
     bool read_stdin = false;
     bool write_stdout = false;
 
+    vector<std::string> NAMES;
+    std::unordered_map<std::string, Symbol> IDS;
+
 public:
     Symbol BEGIN_SYMBOL;
+    Symbol FIRST_NEZAVRSNI; //završni znakovi su [1, FIRST_NEZAVRSNI), nezavršni [FIRST_NEZAVRSNI, size())
     set<Symbol> NEZAVRSNI;
     set<Symbol> ZAVRSNI;
     set<Symbol> SYNC_ZAVRSNI;
@@ -18,9 +75,19 @@ public:
     map<Symbol, vector<Word>> PRODUKCIJE;
     map<pair<Symbol, Word>, int> ID_PRODUKCIJE;
     int ID_global = 0;
+
+    //sve produkcije po id-u (desna strana obrnuta kao u PRODUKCIJE), na kraju je početna <<S'>> -> S
+    vector<pair<Symbol, Word>> PRODUKCIJA;
+    vector<vector<int>> PRODUKCIJE_OD; //id-evi produkcija svakog znaka
+    int POCETNA = -1;
     
-    mutable map<pair<Symbol, Symbol>, bool> BEGINS_WITH; 
-    mutable map<Symbol, set<Symbol>> BEGINS_WITH_ALL; 
+    //ZAPOCINJE[znak] su završni znakovi kojima znak može započeti, PRAZNI[znak] može li se znak poništiti
+    //računa se jednom (izracunajZapocinje), nakon toga su upiti O(1)
+    vector<Bitset> ZAPOCINJE;
+    vector<bool> PRAZNI;
+    //isto za ostatak svake produkcije iza prvih d znakova, SUFIKS_*[produkcija][d]
+    vector<vector<Bitset>> SUFIKS_ZAPOCINJE;
+    vector<vector<bool>> SUFIKS_PRAZAN;
     
     Grammar(const std::string& inputStream)
     {
@@ -35,219 +102,268 @@ public:
 
         if (read_stdin || in.is_open())
         {
-            Symbol currSymbol = "";
+            vector<std::string> nezavrsni, zavrsni, sync;
+            bool interned = false;
+
+            Symbol currSymbol = eps;
             while(getline(GEN_IN))
             {
                 if(line[0] == '%')
                 {
                     if(line[1] == 'V')
-                        BEGIN_SYMBOL = readSymbol(line, NEZAVRSNI);
+                        readSymbol(line, nezavrsni);
                     else if(line[1] == 'T') 
-                        readSymbol(line, ZAVRSNI); 
+                        readSymbol(line, zavrsni); 
                     else if(line.substr(1, 3) == "Syn") 
-                        readSymbol(line, SYNC_ZAVRSNI, 5);
+                        readSymbol(line, sync, 5);
                     else 
                         cerr << "Error in file" <<endl;          
+                    continue;
+                }
+
+                //zaglavlje je pročitano, završni znakovi dobivaju manje brojeve od nezavršnih
+                if (!interned) {
+                    internSymbols(nezavrsni, zavrsni, sync);
+                    interned = true;
                 }
-                else if(line[0] == '<')
+
+                if(line[0] == '<')
                 {
-                    currSymbol = line;
+                    currSymbol = symbol(line);
                 }
                 else if(line[0] == ' ')
                 {
                     Word production = {};
-                    Symbol symbolsString = line.substr(1, (int) line.size() - 1);
+                    std::string symbolsString = line.substr(1, (int) line.size() - 1);
 
-                    consumeEachWord(symbolsString, [&production](const Symbol& sym) {
-                        production.emplace_back(sym);
+                    consumeEachWord(symbolsString, [this, &production](const std::string& sym) {
+                        production.emplace_back(symbol(sym));
                     });
                     //usklađeno radi obrnutosti LR1Stavka.after_dot vectora
                     production = reverse(production); //REVERSE
                     
                     PRODUKCIJE[currSymbol].emplace_back(production);
+                    PRODUKCIJA.emplace_back(currSymbol, production);
                     ID_PRODUKCIJE[{currSymbol, production}] = ID_global++;
                 }
                 else
                     cerr << "Error in file" <<endl;
             }
+            if (!interned) internSymbols(nezavrsni, zavrsni, sync);
             in.close();
+            izracunajZapocinje();
         } 
         else
             cerr << "Unable to open file" <<endl;
     }
 
-    Symbol readSymbol (const std::string line, set<Symbol>& container, int removeFirst = 3) 
+    void readSymbol (const std::string line, vector<std::string>& container, int removeFirst = 3) 
     {
-        Symbol symbolsString = line.substr(removeFirst, (int) line.size() - removeFirst);
-        Symbol firstSymbol = "";
+        std::string symbolsString = line.substr(removeFirst, (int) line.size() - removeFirst);
         
-        consumeEachWord(symbolsString, [&firstSymbol, &container] (const Symbol& sym){
-            if (firstSymbol == "") firstSymbol = sym;
-            container.emplace(sym);
+        consumeEachWord(symbolsString, [&container] (const std::string& sym){
+            container.emplace_back(sym);
         });
-        
-        return firstSymbol;
     }
 
-    bool startsWith (const Symbol& sym1, const Symbol& sym2) const 
+    //vraća id znaka, a ako ga još nema dodaje ga na kraj
+    Symbol symbol (const std::string& name) 
     {
-        pair<Symbol, Symbol> key = {sym1, sym2};
+        auto it = IDS.find(name);
+        if (it != IDS.end()) return it->second;
+        NAMES.emplace_back(name);
+        return IDS[name] = (Symbol) NAMES.size() - 1;
+    }
 
-        if (!exists(BEGINS_WITH, key)) 
-        {
-            BEGINS_WITH[key] = false;
-            
-            if (sym1 == sym2)
-                BEGINS_WITH[key] = true;
-            
-            else if (PRODUKCIJE.count(sym1))
-                for (const Word& produkcija : PRODUKCIJE.at(sym1))
-                    if (startsWith(produkcija, sym2)) 
-                        BEGINS_WITH[key] = true;
-        }
+    inline const std::string& name (Symbol sym) const {
+        return NAMES[sym];
+    }
 
-        return BEGINS_WITH.at({sym1, sym2});
+    inline std::size_t size () const {
+        return NAMES.size();
     }
 
-    bool startsWith (const Word& word, const Symbol& sym2) const 
+    //ispis produkcije (spremljene obrnuto) u normalnom redoslijedu
+    std::string toString (const Word& word, const std::string delim = " ") const 
     {
-        //usklađeno radi obrnutosti LR1Stavka.after_dot vectora
-        for (int i = (int) word.size() - 1; i > -1; i--)  //REVERSE
-        {
-            const Symbol& sym1 = word[i];
-
-            if (startsWith(sym1, sym2)) {
-                if (sym2 != end_sym) return true;
-            }
-            else if (!isVanishing(sym1))
-                return false;
+        std::string rez = "";
+        for (int i = (int) word.size() - 1; i > -1; i--) {
+            rez += name(word[i]);
+            if (i) rez += delim;
         }
-
-        return sym2 == end_sym;
+        return rez;
     }
 
-    bool isVanishing (const Word& word) const {
-        return startsWith(word, end_sym);
-    }
-    bool isVanishing (const Symbol& sym) const {
-        return startsWith(sym, end_sym);
+private:
+    void internSymbols (const vector<std::string>& nezavrsni, const vector<std::string>& zavrsni, const vector<std::string>& sync) 
+    {
+        symbol(EPS_NAME);
+        for (const std::string& sym : zavrsni) ZAVRSNI.emplace(symbol(sym));
+        FIRST_NEZAVRSNI = NAMES.size();
+        for (const std::string& sym : nezavrsni) NEZAVRSNI.emplace(symbol(sym));
+        for (const std::string& sym : sync) SYNC_ZAVRSNI.emplace(symbol(sym));
+        BEGIN_SYMBOL = nezavrsni.empty() ? eps : symbol(nezavrsni.front());
     }
 
-    set<Symbol> startsWith (const Word& word) const 
-    {   
-        set<Symbol> rez;
+public:
 
-        //isto usklađeno...
-        for (int i = (int) word.size() - 1; i > -1; i--)  //REVERSE
+    /*
+        ZAPOCINJE i PRAZNI iteracijom do fiksne točke s listom produkcija za obradu.
+        Kad se skup nekog nezavršnog znaka promijeni, ponovno se obrađuju samo produkcije
+        u kojima se on pojavljuje s desne strane. Za razliku od rekurzije s memoizacijom
+        ovo daje točan rezultat i kod lijeve rekurzije.
+    */
+    void izracunajZapocinje ()
+    {
+        PRODUKCIJE_OD.assign(size(), {});
+        for (int id = 0; id < (int) PRODUKCIJA.size(); id++)
+            PRODUKCIJE_OD[PRODUKCIJA[id].first].push_back(id);
+
+        vector<pair<Symbol, const Word*>> produkcije;
+        vector<vector<int>> koristi(size());
+
+        for (const auto& [left, words] : PRODUKCIJE)
+            for (const Word& word : words) {
+                for (const Symbol& sym : word) 
+                    koristi[sym].push_back(produkcije.size());
+                produkcije.emplace_back(left, &word);
+            }
+
+        ZAPOCINJE.assign(size(), Bitset(FIRST_NEZAVRSNI));
+        PRAZNI.assign(size(), false);
+        PRAZNI[eps] = true;
+        for (const Symbol& sym : ZAVRSNI) ZAPOCINJE[sym].set(sym);
+
+        queue<int> worklist;
+        vector<bool> queued(produkcije.size(), true);
+        for (int i = 0; i < (int) produkcije.size(); i++) worklist.push(i);
+
+        while (!worklist.empty())
         {
-            const Symbol& sym = word[i];
+            int id = worklist.front();
+            worklist.pop();
+            queued[id] = false;
+
+            const auto& [left, word] = produkcije[id];
+            bool changed = (ZAPOCINJE[left] |= startsWith(*word));
+            if (!PRAZNI[left] && isVanishing(*word))
+                changed = PRAZNI[left] = true;
 
-            rez = make_union(rez, startsWith(sym));
-            
-            if (!isVanishing(sym)) break;
+            if (changed)
+                for (int user : koristi[left])
+                    if (!queued[user]) {
+                        queued[user] = true;
+                        worklist.push(user);
+                    }
         }
-        
-        return rez;
-    }
 
-    set<Symbol> startsWith (const Symbol& sym) const 
-    {
-        if (!exists(BEGINS_WITH_ALL, sym)) 
+        SUFIKS_ZAPOCINJE.assign(PRODUKCIJA.size(), {});
+        SUFIKS_PRAZAN.assign(PRODUKCIJA.size(), {});
+        for (int id = 0; id < (int) PRODUKCIJA.size(); id++) 
         {
-            BEGINS_WITH_ALL[sym] = {};
-
-            if (!PRODUKCIJE.count(sym)) 
-                BEGINS_WITH_ALL[sym] = ZAVRSNI.count(sym) ? set<Symbol>{sym} : set<Symbol>{};
-            else {
-                set<Symbol> rez;
-                for (const Word& produkcija : PRODUKCIJE.at(sym))
-                    rez = make_union(rez, startsWith(produkcija));
-                
-                BEGINS_WITH_ALL[sym] = rez;
+            const Word& word = PRODUKCIJA[id].second;
+            int n = word.size();
+            SUFIKS_ZAPOCINJE[id].assign(n + 1, Bitset(FIRST_NEZAVRSNI));
+            SUFIKS_PRAZAN[id].assign(n + 1, true);
+            //obrnuto spremljena produkcija: znak na poziciji d je word[n - 1 - d]
+            for (int d = n - 1; d >= 0; d--) {
+                const Symbol& sym = word[n - 1 - d];
+                SUFIKS_ZAPOCINJE[id][d] = ZAPOCINJE[sym];
+                if (isVanishing(sym)) SUFIKS_ZAPOCINJE[id][d] |= SUFIKS_ZAPOCINJE[id][d + 1];
+                SUFIKS_PRAZAN[id][d] = isVanishing(sym) && SUFIKS_PRAZAN[id][d + 1];
             }
         }
+    }
 
-        return BEGINS_WITH_ALL.at(sym);
+    //pristup znakovima stavke
+    inline Symbol left (const LR1Item& item) const {
+        return PRODUKCIJA[item.production].first;
     }
 
-    inline bool isTerminating(const Symbol& sym) const {
-        return (bool) ZAVRSNI.count(sym);
+    inline Symbol symbolAfterDot (const LR1Item& item) const {
+        const Word& word = PRODUKCIJA[item.production].second;
+        return item.dot < (int) word.size() ? word[word.size() - 1 - item.dot] : end_sym;
     }
 
-    void dodajNoviPocetniZnak (const Symbol& newStartSym)
-    {
-        NEZAVRSNI.emplace(newStartSym);
-        PRODUKCIJE[newStartSym] = {{BEGIN_SYMBOL}};
-        BEGIN_SYMBOL = newStartSym;
+    inline bool isComplete (const LR1Item& item) const {
+        return symbolAfterDot(item) == end_sym;
     }
-};
 
-struct LR1Item 
-{
-    Symbol left;               
-    Word before_dot; 
-    Word after_dot;
-    set<Symbol> lookahead;
+    //lookahead stavki koje se dodaju zatvaranjem iz ove (pravila i) ii) iz skripte str 148)
+    Bitset closureLookahead (const LR1Item& item) const 
+    {
+        int beta = item.dot + 1;
+        Bitset T = SUFIKS_ZAPOCINJE[item.production][beta];
+        if (SUFIKS_PRAZAN[item.production][beta]) T |= item.lookahead;
+        return T;
+    }
 
-    LR1Item () : LR1Item("", {}) {}
+    LR1Item pocetnaStavka () const 
+    {
+        Bitset lookahead(FIRST_NEZAVRSNI);
+        lookahead.set(end_sym);
+        return {POCETNA, 0, lookahead};
+    }
 
-    LR1Item(const Symbol& left) : LR1Item(left, {}) {}
+    bool startsWith (const Symbol& sym1, const Symbol& sym2) const 
+    {
+        if (sym2 == end_sym) return isVanishing(sym1);
+        return sym1 == sym2 || ZAPOCINJE[sym1].test(sym2);
+    }
 
-    LR1Item (const Symbol& left, const Word& after_dot)
-        : LR1Item(left, after_dot, {}) 
-    {}
+    bool startsWith (const Word& word, const Symbol& sym2) const 
+    {
+        if (sym2 == end_sym) return isVanishing(word);
 
-    LR1Item (const Symbol& left, const Word& after_dot, const set<Symbol>& lookahead)
-        : LR1Item(left, {}, after_dot, lookahead) 
-    {}
+        //usklađeno radi obrnutosti LR1Stavka.after_dot vectora
+        for (int i = (int) word.size() - 1; i > -1; i--)  //REVERSE
+        {
+            if (startsWith(word[i], sym2)) return true;
+            if (!isVanishing(word[i])) return false;
+        }
+        return false;
+    }
 
-    LR1Item (const Symbol& left, const Word& before_dot, const Word& after_dot, const set<Symbol>& lookahead)
-        : left(left), before_dot(before_dot), after_dot(after_dot), lookahead(lookahead) 
-    {}
-    
-    bool operator==(const LR1Item& other) const {
-        return left == other.left &&
-               before_dot == other.before_dot &&
-               after_dot == other.after_dot &&
-               lookahead == other.lookahead;
+    bool isVanishing (const Word& word) const {
+        for (const Symbol& sym : word)
+            if (!isVanishing(sym)) return false;
+        return true;
     }
-    
-    bool operator<(const LR1Item& other) const {
-        if (left != other.left) return left < other.left;
-        if (before_dot != other.before_dot) return before_dot < other.before_dot;
-        if (after_dot != other.after_dot) return after_dot < other.after_dot;
-        return lookahead < other.lookahead;
+    inline bool isVanishing (const Symbol& sym) const {
+        return PRAZNI[sym];
     }
 
-    LR1Item &shift_dot_r () {
-        before_dot.push_back(after_dot.back());
-        after_dot.pop_back();
-        return *this;
-    }
-    LR1Item &shift_dot_l () {
-        after_dot.push_back(before_dot.back());
-        before_dot.pop_back();
-        return *this;
+    inline const Bitset& startsWith (const Symbol& sym) const {
+        return ZAPOCINJE[sym];
     }
 
-    inline const Symbol& symbolAfterDot() {
-        return after_dot.empty() ? end_sym : after_dot.back();
+    Bitset startsWith (const Word& word) const 
+    {   
+        Bitset rez(FIRST_NEZAVRSNI);
+
+        //isto usklađeno...
+        for (int i = (int) word.size() - 1; i > -1; i--)  //REVERSE
+        {
+            rez |= ZAPOCINJE[word[i]];
+            if (!isVanishing(word[i])) break;
+        }
+        
+        return rez;
     }
 
-    inline bool isComplete() {
-        return symbolAfterDot() == end_sym;
+    inline bool isTerminating(const Symbol& sym) const {
+        return sym > eps && sym < FIRST_NEZAVRSNI;
     }
-};
 
-template <>
-struct std::hash<LR1Item>
-{
-    std::size_t operator()(const LR1Item& k) const
+    void dodajNoviPocetniZnak (const std::string& newStartName)
     {
-        return (
-            (((std::hash<Symbol>()(k.left) ^ 
-            (std::hash<Word>()(k.before_dot) << 1)) >> 1) ^ 
-            (std::hash<Word>()(k.after_dot) << 1)) >> 1) ^ 
-            (std::hash<set<Symbol>>()(k.lookahead) << 1);
+        Symbol newStartSym = symbol(newStartName);
+        NEZAVRSNI.emplace(newStartSym);
+        PRODUKCIJE[newStartSym] = {{BEGIN_SYMBOL}};
+        POCETNA = PRODUKCIJA.size();
+        PRODUKCIJA.emplace_back(newStartSym, Word{BEGIN_SYMBOL});
+        BEGIN_SYMBOL = newStartSym;
+        izracunajZapocinje();
     }
-};
\ No newline at end of file
+};
+
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+#include <sys/resource.h>
+#include "utils.hpp"
+
+/*
+    Mjerenje faza generatora (--profile trace.json): za svaku fazu trajanje, broj i ukupna veličina alokacija,
+    najveći RSS procesa do kraja faze i brojevi objekata koje faza napravi (stanja, prijelazi, stavke, ...).
+    Zapisuje se u Chrome trace formatu (chrome://tracing ili ui.perfetto.dev), svaka faza je jedan "X" događaj,
+    a brojevi su u njegovim args.
+
+    Alokacije broji zamjena globalnog operator new u generator.cpp (profiler::count), ovdje su samo brojači.
+    Dok profiliranje nije uključeno, operator new košta jednu provjeru zastavice.
+*/
+namespace profiler
+{
+
+inline std::atomic<bool> enabled{false};
+inline std::atomic<uint64_t> allocations{0}, allocatedBytes{0};
+
+inline void count (std::size_t size) {
+    if (enabled.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+struct Phase {
+    std::string name;
+    double start_us, duration_us;
+    uint64_t allocations, bytes;
+    long peak_rss_kb;
+    vector<pair<std::string, uint64_t>> counts;
+};
+
+class Profiler
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point begin = Clock::now(), last = begin;
+    uint64_t lastAllocations = 0, lastBytes = 0;
+
+public:
+    vector<Phase> phases;
+
+    //faza traje od kraja prethodne (ili od stvaranja profilera) do sada
+    void end (const std::string& name, vector<pair<std::string, uint64_t>> counts = {})
+    {
+        Clock::time_point now = Clock::now();
+        uint64_t count = allocations.load(std::memory_order_relaxed), bytes = allocatedBytes.load(std::memory_order_relaxed);
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        phases.push_back({name,
+            std::chrono::duration<double, std::micro>(last - begin).count(),
+            std::chrono::duration<double, std::micro>(now - last).count(),
+            count - lastAllocations, bytes - lastBytes, usage.ru_maxrss, std::move(counts)});
+
+        last = now;
+        lastAllocations = count;
+        lastBytes = bytes;
+    }
+
+    bool writeChromeTrace (const std::string& filename) const
+    {
+        FILE* out = fopen(filename.c_str(), "w");
+        if (!out) return false;
+
+        fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        fprintf(out, "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"generator\"}}");
+        for (const Phase& phase : phases) {
+            fprintf(out, ",\n  {\"name\": \"%s\", \"cat\": \"generator\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+                "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"allocations\": %llu, \"allocated_bytes\": %llu, \"peak_rss_kb\": %ld",
+                phase.name.c_str(), phase.start_us, phase.duration_us,
+                (unsigned long long) phase.allocations, (unsigned long long) phase.bytes, phase.peak_rss_kb);
+            for (const auto& [key, value] : phase.counts)
+                fprintf(out, ", \"%s\": %llu", key.c_str(), (unsigned long long) value);
+            fprintf(out, "}}");
+        }
+        fprintf(out, "\n]}\n");
+        return fclose(out) == 0;
+    }
+};
+
+}
@@ -21,13 +21,15 @@ using std::pair;
 using std::queue;
 
 //ovo bi vjv trebalo definirati lokalno u klasama, ali se koriste dovoljno često izvan klasa pa je ok
-using Symbol = std::string;
+//znakovi gramatike su internirani u gusto numerirane int-ove (Grammar::symbol / Grammar::name)
+using Symbol = int;
 using State = int;
 using Word = vector<Symbol>;
 
-static const Symbol GRAMMAR_NEW_BEGIN_STATE = "<<S'>>";
-static const Symbol eps = "$";
-static const Symbol end_sym = "$";
+static const std::string GRAMMAR_NEW_BEGIN_STATE = "<<S'>>";
+static const std::string EPS_NAME = "$";
+static const Symbol eps = 0;
+static const Symbol end_sym = 0;
 
 using std::cin;
 using std::cout;
@@ -50,6 +52,87 @@ vector<T> reverse (const vector<T>& vec) {
     return rez;
 }
 
+/*
+    Skup malih int-ova (npr. id-eva završnih znakova) kao niz 64-bitnih riječi.
+    |= vraća je li se skup promijenio, što treba za iteraciju do fiksne točke.
+*/
+class Bitset
+{
+    vector<uint64_t> words;
+
+public:
+    Bitset (std::size_t bits = 0) : words((bits + 63) / 64, 0) {}
+
+    inline bool test (std::size_t bit) const {
+        return bit / 64 < words.size() && (words[bit / 64] >> (bit % 64) & 1);
+    }
+
+    inline void set (std::size_t bit) {
+        if (bit / 64 >= words.size()) words.resize(bit / 64 + 1, 0);
+        words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+
+    bool operator|= (const Bitset& other) 
+    {
+        if (other.words.size() > words.size()) words.resize(other.words.size(), 0);
+        bool changed = false;
+        for (std::size_t i = 0; i < other.words.size(); i++) {
+            uint64_t merged = words[i] | other.words[i];
+            changed |= merged != words[i];
+            words[i] = merged;
+        }
+        return changed;
+    }
+
+    bool intersects (const Bitset& other) const 
+    {
+        for (std::size_t i = 0; i < std::min(words.size(), other.words.size()); i++)
+            if (words[i] & other.words[i]) return true;
+        return false;
+    }
+
+    bool any () const 
+    {
+        for (uint64_t w : words)
+            if (w) return true;
+        return false;
+    }
+
+    //riječi koje nedostaju se smatraju nulama, pa usporedba ne ovisi o veličini
+    int compare (const Bitset& other) const 
+    {
+        for (std::size_t i = 0; i < std::max(words.size(), other.words.size()); i++) {
+            uint64_t a = word(i), b = other.word(i);
+            if (a != b) return a < b ? -1 : 1;
+        }
+        return 0;
+    }
+
+    bool operator== (const Bitset& other) const { return compare(other) == 0; }
+    bool operator!= (const Bitset& other) const { return compare(other) != 0; }
+    bool operator< (const Bitset& other) const { return compare(other) < 0; }
+
+    std::size_t hash () const 
+    {
+        std::size_t seed = 0;
+        for (std::size_t i = 0; i < words.size(); i++)
+            if (words[i]) seed ^= (words[i] + i) * 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+
+    inline uint64_t word (std::size_t i) const {
+        return i < words.size() ? words[i] : 0;
+    }
+
+    template<typename Action>
+    void forEach (Action action) const 
+    {
+        for (std::size_t i = 0; i < words.size(); i++)
+            for (uint64_t w = words[i]; w; w &= w - 1)
+                action((int) (i * 64 + __builtin_ctzll(w)));
+    }
+};
+
 template <typename T>
 struct std::hash<set<T>> {
     std::size_t operator() (const set<T>& s) const {
@@ -0,0 +1,49 @@
+import os
+import subprocess
+
+# Testovi spojenog leksičkog i sintaksnog analizatora (src/frontend), pokreće se iz Lab2-SyntaxAnalyzer kao testerLA.py.
+# Svaki test je (pravila iz Lab1, gramatika iz Lab2, ulaz), a frontend mora završiti unutar TIMEOUT sekundi.
+#   python3 testFrontend.py
+
+red     = "\033[0;31m"
+green   = "\033[0;32m"
+nocolor = "\033[0m"
+
+TIMEOUT = 10
+
+cwd = os.getcwd()
+lab1 = cwd + "/../Lab1-LexicalAnalyzer"
+src = cwd + "/src"
+frontend = src + "/frontend"
+
+TESTS = [
+    # parser odustane na pola ulaza (oporavak ne uspije), a leksički analizator ima još puno jedinki za poslati:
+    # prije je čekao na pun red zauvijek i frontend se nikad nije ugasio
+    ("ppjLang_tezi", lab1 + "/test/ppjLang_tezi.lan", cwd + "/test/13ppjLang/test.san", lab1 + "/test/ppjLang_tezi.in"),
+]
+
+subprocess.run(["g++", "Generator.cpp", "Regex.cpp", "automata.cpp", "-std=c++17", "-O2", "-o", "GEN"], cwd=lab1 + "/src", check=True)
+subprocess.run(["g++", "generator.cpp", "-std=c++17", "-O2", "-o", "generator"], cwd=src, check=True)
+subprocess.run(["g++", "frontend.cpp", "../../../Lab1-LexicalAnalyzer/src/analizator/automata.cpp",
+                "-std=c++17", "-O2", "-pthread", "-o", "frontend"], cwd=frontend, check=True)
+
+passed = 0
+for name, lan, san, program in TESTS:
+    with open(lan) as file:
+        subprocess.run(["./GEN"], cwd=lab1 + "/src", stdin=file, check=True)
+    with open(san) as file:
+        subprocess.run(["./generator"], cwd=src, stdin=file, stderr=subprocess.DEVNULL, check=True)
+
+    try:
+        with open(program) as file:
+            done = subprocess.run(["./frontend", lab1 + "/src/analizator/table.txt", src + "/analizator/tablica.txt"],
+                                  cwd=frontend, stdin=file, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                                  timeout=TIMEOUT)
+        ok = done.returncode == 0
+    except subprocess.TimeoutExpired:
+        ok = False
+
+    passed += ok
+    print(f"{name:<20} {green + 'OK' if ok else red + 'FAIL'}{nocolor}")
+
+print(f"{passed}/{len(TESTS)}")
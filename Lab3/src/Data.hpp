@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Types.hpp"
+#include "../../Lab2-SyntaxAnalyzer/src/analizator/TreeFormat.hpp"
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 struct SymbolTable
 {
@@ -49,6 +55,8 @@ namespace TreeUtils
 {
     static Node *buildTree();
 
+    static Node *buildTree(const tree::View &view);
+
     static pair<int, string> parseContent(const string &line);
 
     static int getIndentationLevel(const string &line);
@@ -77,7 +85,7 @@ struct Node
     Node();
 
     Node(string symbol, Node *parent = nullptr, string content = "")
-        : symbol(symbol), parent(parent), content(content)
+        : parent(parent), symbol(symbol), isLValue(false), content(content), arraySize(-1)
     {
         if (content != "")
         {
@@ -87,6 +95,11 @@ struct Node
         }
     }
 
+    // List iz binarnog stabla, dijelovi retka su vec razdvojeni
+    Node(string symbol, Node *parent, string content, string lineNumber, string lexicalUnit)
+        : parent(parent), symbol(symbol), isLValue(false), content(content), lineNumber(lineNumber),
+          lexicalUnit(lexicalUnit), arraySize(-1) {}
+
     bool isTerminating() { return !(symbol[0] == '<'); }
 
     bool isNewScope(Node *node) { return node->symbol == "<slozena_naredba>" ||
@@ -106,8 +119,31 @@ struct Node
 
 namespace TreeUtils
 {
+    // Stablo s uvlakama (ispis Lab2 analizatora) ili binarno stablo (--tree-bin), prepoznaje se po magic broju
     Node *buildTree()
     {
+        struct stat st;
+        if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= (off_t)sizeof(tree::Header))
+        {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+            if (data != MAP_FAILED)
+            {
+                tree::View view;
+                Node *root = view.load((const char *)data, st.st_size) ? buildTree(view) : nullptr;
+                munmap(data, st.st_size);
+                if (root)
+                    return root;
+            }
+        }
+        else if (cin.peek() == tree::MAGIC[0])
+        {
+            // iz cijevi se ne moze mmapati, pa se procita sve odjednom
+            string data((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+            tree::View view;
+            if (view.load(data.data(), data.size()))
+                return buildTree(view);
+        }
+
         string line;
         getline(cin, line);
 
@@ -138,6 +174,44 @@ namespace TreeUtils
         return stack[0].second;
     }
 
+    Node *buildTree(const tree::View &view)
+    {
+        // cvorovi su u preorderu, na stogu su cvorovi kojima jos fale djeca i koliko ih fali
+        vector<pair<Node *, uint32_t>> stack;
+        Node *root = nullptr;
+
+        for (uint32_t i = 0; i < view.header->nodes; i++)
+        {
+            const tree::Record &record = view.nodes[i];
+            Node *parent = stack.empty() ? nullptr : stack.back().first;
+
+            size_t length;
+            const char *name = view.name(record.symbol, length);
+            Node *node;
+            if (record.symbol == 0 || name[0] != '<')
+                node = new Node(string(name, length), parent,
+                                string(view.pool + record.content_begin, record.content_size),
+                                record.line < 0 ? "" : to_string(record.line),
+                                string(view.pool + record.unit_begin, record.unit_size));
+            else
+                node = new Node(string(name, length), parent);
+
+            if (parent)
+            {
+                parent->children.push_back(node);
+                stack.back().second--;
+            }
+            else
+                root = node;
+
+            if (record.children)
+                stack.push_back({node, record.children});
+            while (!stack.empty() && stack.back().second == 0)
+                stack.pop_back();
+        }
+        return root;
+    }
+
     // Function to parse node name and indent number from line
     pair<int, string> parseContent(const string &line)
     {